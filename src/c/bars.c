@@ -3,23 +3,127 @@
 
 /*** Constants ***/
 const float BAR_SPACING = 8.0;
-const int CORNER_RADIUS = 4;
 const int LABEL_HORIZ_SPACING = 1;
-const int LABEL_WIDTH = 8;
 const int WEATHER_UPDATE_FREQUENCY_MS = 900000; //15 minutes
+const int SNAPSHOT_VERSION = 4;
+
+/* The label fonts only contain the characters these labels can produce (see the 
+characterRegex of the font resources). The build checks the formats used below 
+against it, so new label formats may need the regex extended. */
+#define LABEL_WIDTH 8
+
+/* Set to 1 to log how long each frame takes to draw on the watch, tagged with the 
+visible bars and bar style. The host sweep in test/ checks the pixels and a 
+platform-independent cost across all configurations; this is for confirming 
+the timings on real hardware. */
+#define PROFILE_FRAMES 0
+
+#define MAX_VISIBLE_BARS (TOTAL_BARS + MAX_REMOTE_METRICS)
+
+/*** Types ***/
+
+/**
+ * Where each visible bar goes on screen, in drawing order, in whole pixels.
+ */
+typedef struct {
+	int count;
+	int16_t y[MAX_VISIBLE_BARS];
+	int16_t height[MAX_VISIBLE_BARS];
+} bars_layout_t;
+
+/**
+ * Everything needed to draw a frame: the layout plan along with each bar's
+ * progress and label. Persisted on exit so the next launch can draw its first 
+ * frame straight away instead of waiting for all the services.
+ */
+typedef struct {
+	int version;
+	uint32_t shown_bars;
+	float progress[TOTAL_BARS];
+	char labels[TOTAL_BARS][LABEL_WIDTH];
+} bars_snapshot_t;
 
 /*** Internal Global Variables ***/
-static float bar_height;
 static GFont font_for_text;
+static uint32_t font_resource_id;
 static Layer *layer_bars;
 static float progress[TOTAL_BARS];
-static char *labels[TOTAL_BARS];
+static char labels[TOTAL_BARS][LABEL_WIDTH];
 static app_settings_t settings;
+static draw_bar_fn draw_bar;
+
+/* The layouts for the whole screen and for when the timeline quick view covers 
+part of it, and the one currently drawn. While the quick view slides in or out, 
+the current layout moves from the starting one towards the target. */
+static bars_layout_t full_layout;
+static bars_layout_t obstructed_layout;
+static bars_layout_t layout;
+static const bars_layout_t *layout_target;
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+static bars_layout_t layout_start;
+#endif
+
+/* Today's sunrise and sunset, or NULL until the location is known. */
+static const daylight_t *todays_daylight;
+
+/* Set while quiet mode has suspended everything but the minute-level time updates. */
+static bool quiet;
+
+/* Cached rendering of the hourly steps sparkline, redrawn only when the 
+history, the bar color or the bar height change. */
+static GBitmap *sparkline_bitmap;
+static bool sparkline_dirty;
+
+/* Used to measure the time from launch until the first frame is drawn. */
+static time_t launch_time_s;
+static uint16_t launch_time_ms;
+static bool first_frame_drawn;
+
+/* Set when the first frame was restored from the snapshot and the rest of 
+the startup work is waiting on it being drawn. */
+static Window *startup_window;
 
 /*** Internal Functions ***/
+static void first_frame_done();
+static void update_quiet_mode(struct tm *tick_time);
+static uint32_t get_shown_bars();
+
+/** 
+ * Works out where a bar's text label goes: just past the end of the filled part 
+ * of the bar, centered vertically.
+ * 
+ * @param GRect bounds: Bounds of the graphics layer. 
+ * @param char *label: The text to be drawn.
+ * @param int bar_filled_width: Width of the filled part of the bar.
+ * @param int bar_y: y-position of the top of the bar.
+ * @param int height: Height of the bar.
+ * @return GRect: The box to draw the label in.
+ */
+static GRect get_label_rect(GRect bounds, char *label, int bar_filled_width, 
+							int bar_y, int height) {
+	GSize text_size = graphics_text_layout_get_content_size(label, font_for_text, bounds,
+															GTextOverflowModeWordWrap, GTextAlignmentCenter);
+
+	/* This formula is used to make sure the text is centered on each bar. */
+	int label_vert_offset = (height - text_size.h) / 2.1 - 2;
+	
+	/* Draw the label at the end of the bar, but don't go off the screen when the bar
+	is all the way full or off the chart (e.g. in extreme temperature, for example). */
+	int label_x = bar_filled_width + LABEL_HORIZ_SPACING;
+	if (label_x < 0) {
+		label_x = 0;
+	}
+	else if (label_x > PBL_DISPLAY_WIDTH - text_size.w) {
+		label_x = PBL_DISPLAY_WIDTH - text_size.w;
+	}
+
+	int label_y = bar_y + label_vert_offset;
+	return GRect(label_x, label_y, text_size.w, text_size.h);
+}
 
 /** 
- * Draws a single horizontal bar.
+ * Draws a single horizontal bar, using the draw routine picked for the 
+ * current bar style and text colors.
  * 
  * @param GRect bounds: Bounds of the graphics layer. 
  * @param Gcontext *ctx: Graphics context to draw in. Passed along from the LayerUpdateProc.
@@ -27,55 +131,131 @@ static app_settings_t settings;
  *	0.0 is empty, 1.0 fills though whole screen.
  * @param char *label: The text to be drawn at the end of the bar.
  * @param GColor fill_color: Color used to draw the bar.
- * @param float height: Height of the bar.
- * @param float *next_bar_start_y: y-position to start the bar at. Will be updated to be
- *	the height at which to start the next bar, based on this one's height. 
+ * @param int bar_y: y-position of the top of the bar, from the layout.
+ * @param int height: Height of the bar, from the layout.
  */
 static void draw_a_bar(GRect bounds, GContext *ctx, float progress, char *label, 
-					   GColor bar_color, float height, float *next_bar_start_y) {
+					   GColor bar_color, int bar_y, int height) {
 
 	int bar_filled_width = PBL_DISPLAY_WIDTH * progress;
 
-	/* Space each bar vertically. */
-	*next_bar_start_y += BAR_SPACING;
+	GRect bar_rect = GRect(0, bar_y, bar_filled_width, height);
+	GRect label_rect = get_label_rect(bounds, label, bar_filled_width, bar_y, height);
+	draw_bar(ctx, bar_rect, bar_color, label, font_for_text, label_rect, 
+			 settings.text_color, settings.text_outline_color);
+}
 
-	/* Draw the rectangle that is the bar. */
-	if (settings.bar_style == SOLID) {
-		graphics_context_set_fill_color(ctx, bar_color);
-		graphics_fill_rect(ctx, GRect(0, round(*next_bar_start_y), bar_filled_width, round(height)), CORNER_RADIUS, GCornersRight);
+/**
+ * Renders the steps taken in each hour of today into the cached sparkline bitmap, 
+ * one column per hour, scaled so the busiest hour fills the height of the bar. 
+ * The pixels are written directly: on color platforms each one is either the 
+ * bar color or clear, and on black and white platforms they are a 1-bit mask,
+ * dithered like a solid bar of the same color.
+ *
+ * @param GRect bar_rect: Where the bar goes on the screen.
+ */
+static void render_sparkline(GRect bar_rect) {
+	GSize size = bar_rect.size;
+	if (sparkline_bitmap) {
+		GSize bitmap_size = gbitmap_get_bounds(sparkline_bitmap).size;
+		if (!gsize_equal(&size, &bitmap_size)) {
+			gbitmap_destroy(sparkline_bitmap);
+			sparkline_bitmap = NULL;
+		}
 	}
-	else {
-		graphics_context_set_stroke_color(ctx, bar_color);
-		/* Since graphics_draw_round_rect only draw 1 pixel wide, draw two rectangles slightly offset.
-		Also, graphics_draw_round_rect does not allow a corner mask, so start it offscreen to avoid 
-		having rounded corners on the left side. */
-		graphics_draw_round_rect(ctx, GRect(-2, round(*next_bar_start_y), bar_filled_width+2, round(height)), CORNER_RADIUS);	
-		graphics_draw_round_rect(ctx, GRect(-2, round(*next_bar_start_y)+1, bar_filled_width+3, round(height)), CORNER_RADIUS);	
+	if (!sparkline_bitmap) {
+		sparkline_bitmap = gbitmap_create_blank(size, PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit));
+		if (!sparkline_bitmap) {
+			return;
+		}
 	}
-	
-	GSize text_size = graphics_text_layout_get_content_size(label, font_for_text, bounds,
-															GTextOverflowModeWordWrap, GTextAlignmentCenter);
 
-	/* This formula is used to make sure the text is centered on each bar. */
-	int label_vert_offset = (height - text_size.h) / 2.1 - 2;
+	const uint16_t *steps_per_hour = step_history_get();
+	int max_steps = 1;
+	for (int h = 0; h < STEP_HISTORY_HOURS; ++h) {
+		max_steps = MAX(max_steps, steps_per_hour[h]);
+	}
+
+	uint8_t *data = gbitmap_get_data(sparkline_bitmap);
+	int bytes_per_row = gbitmap_get_bytes_per_row(sparkline_bitmap);
+	memset(data, 0, bytes_per_row * size.h);
+
+	/* Leave a one pixel gap between the columns. */
+	int column_width = size.w / STEP_HISTORY_HOURS;
+
+#if !defined(PBL_COLOR)
+	/* Black is drawn by clearing the pixels, so its mask is left solid. */
+	GColor color = settings.bar_colors[STEPS_BAR_IDX];
+	const uint8_t *pattern = gcolor_equal(color, GColorBlack) ? NULL : renderers_get_dither_pattern(color);
+#endif
 	
-	/* Draw the label at the end of the bar, but don't go off the screen when the bar
-	is all the way full or off the chart (e.g. in extreme temperature, for example). */
-	int label_x = bar_filled_width + LABEL_HORIZ_SPACING;
-	if (label_x < 0) {
-		label_x = 0;
+	for (int h = 0; h < STEP_HISTORY_HOURS; ++h) {
+		int column_height = steps_per_hour[h] * size.h / max_steps;
+		if (steps_per_hour[h] > 0 && column_height == 0) {
+			column_height = 1;
+		}
+
+		for (int y = size.h - column_height; y < size.h; ++y) {
+			uint8_t *row = data + y * bytes_per_row;
+#if !defined(PBL_COLOR)
+			/* Line the pattern up with the screen rows the bitmap is drawn to. */
+			uint8_t row_pattern = pattern ? pattern[(bar_rect.origin.y + y) % 8] : 0xFF;
+#endif
+			for (int x = h * column_width; x < (h + 1) * column_width - 1; ++x) {
+#if defined(PBL_COLOR)
+				row[x] = settings.bar_colors[STEPS_BAR_IDX].argb;
+#else
+				row[x / 8] |= (1 << (x % 8)) & row_pattern;
+#endif
+			}
+		}
 	}
-	else if (label_x > PBL_DISPLAY_WIDTH - text_size.w) {
-		label_x = PBL_DISPLAY_WIDTH - text_size.w;
+
+	sparkline_dirty = false;
+}
+
+/** 
+ * Draws the steps bar as a sparkline of the steps taken in each hour of today,
+ * with the day's total as the label after the current hour.
+ * 
+ * @param GRect bounds: Bounds of the graphics layer. 
+ * @param Gcontext *ctx: Graphics context to draw in.
+ * @param char *label: The text to be drawn at the end of the bar.
+ * @param int bar_y: y-position of the top of the bar, from the layout.
+ * @param int height: Height of the bar, from the layout.
+ */
+static void draw_sparkline_bar(GRect bounds, GContext *ctx, char *label, 
+							   int bar_y, int height) {
+	GRect sparkline_rect = GRect(0, bar_y, PBL_DISPLAY_WIDTH, height);
+	if (sparkline_dirty || !sparkline_bitmap) {
+		render_sparkline(sparkline_rect);
 	}
 
-	/* Draw the text label. */
-	draw_outlined_text(ctx, label, font_for_text, label_x, *next_bar_start_y + label_vert_offset, 
-					   text_size, settings.text_color, settings.text_outline_color);
+	if (sparkline_bitmap) {
+		/* While the quick view slides, the bitmap is not re-rendered for each frame. 
+		It is drawn at no more than its own height, against the bottom of the bar, 
+		so a shorter bar cuts the tops of the columns rather than their bases. */
+		GRect bitmap_bounds = gbitmap_get_bounds(sparkline_bitmap);
+		int drawn_height = MIN(height, bitmap_bounds.size.h);
+		gbitmap_set_bounds(sparkline_bitmap, GRect(0, bitmap_bounds.size.h - drawn_height, 
+												   bitmap_bounds.size.w, drawn_height));
+		sparkline_rect = GRect(0, bar_y + height - drawn_height, PBL_DISPLAY_WIDTH, drawn_height);
+#if defined(PBL_COLOR)
+		graphics_context_set_compositing_mode(ctx, GCompOpSet);
+#else
+		/* The 1-bit mask sets white pixels, or clears them for a black bar. */
+		graphics_context_set_compositing_mode(ctx, 
+			gcolor_equal(settings.bar_colors[STEPS_BAR_IDX], GColorBlack) ? GCompOpClear : GCompOpOr);
+#endif
+		graphics_draw_bitmap_in_rect(ctx, sparkline_bitmap, sparkline_rect);
+		graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+		gbitmap_set_bounds(sparkline_bitmap, bitmap_bounds);
+	}
 
-	/* Update the starting y-position based on this one's height. The variable can then
-	be passed in subsequent calls without the caller needing to update it. */
-	*next_bar_start_y += height;
+	int current_hour_end = (step_history_current_hour() + 1) * (PBL_DISPLAY_WIDTH / STEP_HISTORY_HOURS);
+	renderers_draw_label(ctx, label, font_for_text, 
+						 get_label_rect(bounds, label, current_hour_end, bar_y, height), 
+						 settings.text_color, settings.text_outline_color);
 }
 
 /**
@@ -86,13 +266,104 @@ static void draw_a_bar(GRect bounds, GContext *ctx, float progress, char *label,
  * @param GContext *ctx: The destination graphics context to draw into.
  */
 static void redraw_bars(Layer *layer, GContext *ctx) {
-	float next_bar_start_y = 0;
+#if PROFILE_FRAMES
+	time_t start_s;
+	uint16_t start_ms;
+	time_ms(&start_s, &start_ms);
+#endif
+
 	GRect l_grect_bounds = layer_get_bounds(layer);
+	int position = 0;
 
-	for (int i = 0; i < TOTAL_BARS; ++i) {
-		if (settings.show_bar[i])
+	for (int i = 0; i < TOTAL_BARS && position < layout.count; ++i) {
+		if (!settings.show_bar[i])
+			continue;
+
+		if (i == STEPS_BAR_IDX && settings.steps_sparkline)
+			draw_sparkline_bar(l_grect_bounds, ctx, labels[i], 
+							   layout.y[position], layout.height[position]);
+		else
 			draw_a_bar(l_grect_bounds, ctx, progress[i], labels[i], settings.bar_colors[i], 
-					   bar_height, &next_bar_start_y);
+					   layout.y[position], layout.height[position]);
+		++position;
+	}
+
+	/* The bars pushed by the phone go after the built-in ones. */
+	for (int i = 0; i < remote_metrics_count() && position < layout.count; ++i) {
+		const remote_metric_t *metric = remote_metrics_get(i);
+		draw_a_bar(l_grect_bounds, ctx, metric->progress_permille / 1000.0, (char *) metric->label, 
+				   metric->color, layout.y[position], layout.height[position]);
+		++position;
+	}
+
+#if PROFILE_FRAMES
+	time_t end_s;
+	uint16_t end_ms;
+	time_ms(&end_s, &end_ms);
+	int elapsed_ms = (end_s - start_s) * 1000 + end_ms - start_ms;
+
+	APP_LOG(APP_LOG_LEVEL_DEBUG, "Frame: bars %03lx style %d remote %d, %d ms.", 
+			(unsigned long) get_shown_bars(), settings.bar_style, remote_metrics_count(), elapsed_ms);
+#endif
+
+	if (!first_frame_drawn) {
+		first_frame_drawn = true;
+		first_frame_done();
+	}
+}
+
+/**
+ * Writes a time of day as a label, following the user's 12h or 24h preference.
+ *
+ * @param char *label: The label to write to.
+ * @param int minutes: The time in minutes after midnight.
+ */
+static void format_time_of_day(char *label, int minutes) {
+	int hour = (minutes / 60) % 24;
+	if (!clock_is_24h_style()) {
+		hour = hour % 12 == 0 ? 12 : hour % 12;
+	}
+	snprintf(label, LABEL_WIDTH, "%d:%02d", hour, minutes % 60);
+}
+
+/**
+ * Recalculates the daylight bar's progress and label from today's sunrise and 
+ * sunset. The bar fills up over the course of the day, and the label shows 
+ * the next sunrise or sunset.
+ *
+ * @param struct tm *tick_time: The current time.
+ */
+static void update_daylight(struct tm *tick_time) {
+	int minutes = tick_time->tm_hour * 60 + tick_time->tm_min;
+
+	if (!todays_daylight || todays_daylight->type == DAYLIGHT_POLAR_NIGHT) {
+		/* Location unknown, or the sun does not rise today. */
+		progress[DAYLIGHT_BAR_IDX] = 0;
+		snprintf(labels[DAYLIGHT_BAR_IDX], LABEL_WIDTH, "-");
+		return;
+	}
+	if (todays_daylight->type == DAYLIGHT_POLAR_DAY) {
+		/* The sun does not set today. */
+		progress[DAYLIGHT_BAR_IDX] = 1;
+		snprintf(labels[DAYLIGHT_BAR_IDX], LABEL_WIDTH, "-");
+		return;
+	}
+
+	int sunrise = todays_daylight->sunrise_minutes;
+	int sunset = todays_daylight->sunset_minutes;
+
+	if (minutes < sunrise) {
+		progress[DAYLIGHT_BAR_IDX] = 0;
+		format_time_of_day(labels[DAYLIGHT_BAR_IDX], sunrise);
+	}
+	else if (minutes < sunset) {
+		progress[DAYLIGHT_BAR_IDX] = (float) (minutes - sunrise) / (sunset - sunrise);
+		format_time_of_day(labels[DAYLIGHT_BAR_IDX], sunset);
+	}
+	else {
+		/* Tomorrow's sunrise is close enough to today's. */
+		progress[DAYLIGHT_BAR_IDX] = 1;
+		format_time_of_day(labels[DAYLIGHT_BAR_IDX], sunrise);
 	}
 }
 
@@ -104,6 +375,11 @@ static void redraw_bars(Layer *layer, GContext *ctx) {
  * @param TimeUnits units_changed: Which unit change triggered this tick event.
  */
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+	/* Check whether quiet mode should start or end. */
+	if (units_changed & MINUTE_UNIT) {
+		update_quiet_mode(tick_time);
+	}
+
 	/* Update the seconds. */
 	if (units_changed & SECOND_UNIT) {
 		if (settings.show_bar[SECONDS_BAR_IDX]) {
@@ -161,6 +437,11 @@ static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
 			progress[COMBINED_MONTH_DAY_BAR_IDX] = tick_time->tm_yday / 365.0;
 			strftime(labels[COMBINED_MONTH_DAY_BAR_IDX], LABEL_WIDTH, "%b %d", tick_time);
 		}
+
+		/* Sunrise and sunset are only calculated once a day, and saved. */
+		if (settings.show_bar[DAYLIGHT_BAR_IDX]) {
+			todays_daylight = daylight_update(tick_time, false);
+		}
 	}
 
 	/* Update the months. */
@@ -171,6 +452,13 @@ static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
 		}	
 	}
 
+	/* Update the daylight, after the day's sunrise and sunset are known. */
+	if (units_changed & MINUTE_UNIT) {
+		if (settings.show_bar[DAYLIGHT_BAR_IDX]) {
+			update_daylight(tick_time);
+		}
+	}
+
 	/* Mark the display dirty. Only update each second if displaying seconds, 
 	else update every minute. */
 	if (((units_changed & SECOND_UNIT) && settings.show_bar[SECONDS_BAR_IDX])
@@ -180,26 +468,46 @@ static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
 }
 
 /**
- * Sends a message to the phone to tell it to fetch the weather. 
+ * Queues a message to the phone to tell it to fetch the weather. 
  */
 static void fetch_weather() { 
-	/* Begin dictionary. */
-	DictionaryIterator *iter;
-	app_message_outbox_begin(&iter);
+	outbox_enqueue(OUTBOX_MESSAGE_FETCH_TEMPERATURE);
+}
 
-	/* Set the FetchTemperature message key to indicate that 
-	the phone should retrieve the temperature. */
-	dict_write_uint8(iter, MESSAGE_KEY_FetchTemperature, 1);
+/**
+ * Returns how long until the weather is next due. The schedule carries on from 
+ * the last weather received, so returning to the watchface does not fetch it 
+ * again unless it is due.
+ *
+ * @return int: Milliseconds until the weather is due, or 0 if it is due now.
+ */
+static int get_weather_due_ms() {
+	if (persist_exists(STORAGE_KEY_WEATHER_TIME)) {
+		int weather_age_s = time(NULL) - persist_read_int(STORAGE_KEY_WEATHER_TIME);
+		if (weather_age_s >= 0 && weather_age_s < WEATHER_UPDATE_FREQUENCY_MS / 1000) {
+			return WEATHER_UPDATE_FREQUENCY_MS - weather_age_s * 1000;
+		}
+	}
+	return 0;
+}
 
-	/* Send the message. */
-	app_message_outbox_send();
+/**
+ * Returns whether any visible bar needs the weather from the phone. The daylight 
+ * bar only needs the location that comes with the weather once.
+ *
+ * @return bool: True if the weather should be fetched.
+ */
+static bool needs_weather() {
+	return settings.show_bar[TEMPERATURE_BAR_IDX] || 
+		(settings.show_bar[DAYLIGHT_BAR_IDX] && !daylight_has_location());
 }
 
 /**
  * Starts a timer to retrieve the weather periodically.
+ * No weather is fetched while in quiet mode.
  */
 static void fetch_weather_timer() {
-	if (settings.show_bar[TEMPERATURE_BAR_IDX]) {
+	if (needs_weather() && !quiet) {
 		fetch_weather(); 
 	}
 
@@ -274,6 +582,17 @@ static void update_steps(int new_steps) {
  * @param void *context: The context pointer.
  */
 static void health_event_callback(HealthEventType event, void *context) {
+	if (event == HealthEventSleepUpdate) {
+		time_t temp = time(NULL);
+		update_quiet_mode(localtime(&temp));
+		return;
+	}
+
+	/* The steps are brought up to date when quiet mode ends. */
+	if (quiet) {
+		return;
+	}
+
 	if (settings.show_bar[STEPS_BAR_IDX] &&
 		(event == HealthEventSignificantUpdate ||
 		 event == HealthEventMovementUpdate)) {
@@ -292,6 +611,11 @@ static void health_event_callback(HealthEventType event, void *context) {
 			steps_today = health_service_sum_today(metric);
 		}
 
+		/* Only redraw the sparkline if the history actually changed. */
+		if (settings.steps_sparkline && step_history_update(steps_today)) {
+			sparkline_dirty = true;
+		}
+
 		update_steps(steps_today);
 
 		/* Save the step count to storage. This is so it can be read when the app loads, 
@@ -301,86 +625,463 @@ static void health_event_callback(HealthEventType event, void *context) {
 }
 
 /**
- * Handles all the updates needed when settigs are changed, such as 
- * showing and hiding bars, updating supscriptions to event services 
- * when those bars are turned on or off, changing the temperature display 
- * from Fahrenheit to Celsius, etc.
+ * Subscribes to the tick timer service every second if the seconds bar is 
+ * shown, or every minute otherwise or while in quiet mode. Subsequent calls 
+ * override the previous subscription, so there is no need to explicilty 
+ * unsubscribe from seconds, for instance.
+ */
+static void subscribe_tick_timer() {
+	if (settings.show_bar[SECONDS_BAR_IDX] && !quiet)
+		tick_timer_service_subscribe(SECOND_UNIT, tick_handler);
+	else
+		tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
+}
+
+/**
+ * Checks whether it is quiet time: either the user is asleep, according to
+ * the health service, or the time is within the configured quiet hours.
  *
- * @param Win *win_main: Pointer to the main window. Needed to set the 
- *	window background color.
+ * @param struct tm *tick_time: The current time.
+ * @return bool: True if quiet mode should be on.
  */
-static void settings_changed(Window *win_main) {
-	/* Turn the light on briefly to highlight the new display. */
-	light_enable_interaction();
+static bool is_quiet_time(struct tm *tick_time) {
+	if (settings.quiet_mode_window) {
+		int hour = tick_time->tm_hour;
+
+		/* The window may wrap around midnight, e.g. 23 to 7. */
+		if (settings.quiet_start_hour <= settings.quiet_end_hour) {
+			if (hour >= settings.quiet_start_hour && hour < settings.quiet_end_hour)
+				return true;
+		}
+		else if (hour >= settings.quiet_start_hour || hour < settings.quiet_end_hour) {
+			return true;
+		}
+	}
+
+	if (settings.quiet_mode_sleep) {
+		HealthActivityMask activities = health_service_peek_current_activities();
+		if (activities & (HealthActivitySleep | HealthActivityRestfulSleep))
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Starts or ends quiet mode as needed. While quiet, the weather is not 
+ * fetched, step updates are ignored and the time only ticks every minute. 
+ * When quiet mode ends, everything is brought up to date in one batch.
+ *
+ * @param struct tm *tick_time: The current time.
+ */
+static void update_quiet_mode(struct tm *tick_time) {
+	bool should_be_quiet = is_quiet_time(tick_time);
+	if (should_be_quiet == quiet) {
+		return;
+	}
+
+	quiet = should_be_quiet;
+	APP_LOG(APP_LOG_LEVEL_INFO, "Quiet mode %s.", quiet ? "started" : "ended");
+	subscribe_tick_timer();
+
+	if (!quiet) {
+		/* Everything at once, so the watch only has to wake up once. */
+		tick_handler(tick_time, SECOND_UNIT|MINUTE_UNIT|HOUR_UNIT|DAY_UNIT|MONTH_UNIT|YEAR_UNIT);
+		health_event_callback(HealthEventSignificantUpdate, NULL);
+		if (settings.show_bar[BATTERY_BAR_IDX]) {
+			battery_callback(battery_state_service_peek());
+		}
+		if (needs_weather()) {
+			fetch_weather();
+		}
+	}
+}
+
+/**
+ * Loads the font used for the labels, unless it is already loaded.
+ *
+ * @param uint32_t resource_id: Resource ID of the font to load.
+ */
+static void load_font(uint32_t resource_id) {
+	if (font_for_text && font_resource_id == resource_id) {
+		return;
+	}
+
+	if (font_for_text) {
+		fonts_unload_custom_font(font_for_text);
+	}
+	font_for_text = fonts_load_custom_font(resource_get_handle(resource_id));
+	font_resource_id = resource_id;
+}
+
+/**
+ * Returns the number of bars on screen, both built-in and pushed by the phone.
+ *
+ * @return int: The count of visible bars.
+ */
+static int count_visible_bars() {
+	return count_enabled_bars(&settings) + remote_metrics_count();
+}
+
+/**
+ * Returns which built-in bars are shown, as a bitmask with bit i set if the 
+ * bar at index i is.
+ *
+ * @return uint32_t: The mask of shown bars.
+ */
+static uint32_t get_shown_bars() {
+	uint32_t shown_bars = 0;
+	for (int i = 0; i < TOTAL_BARS; ++i) {
+		if (settings.show_bar[i])
+			shown_bars |= 1 << i;
+	}
+	return shown_bars;
+}
+
+/**
+ * Works out where each visible bar goes in an area of the given height. The bars 
+ * share the height equally, with BAR_SPACING above each one.
+ *
+ * @param bars_layout_t *out: The layout to fill in.
+ * @param int screen_height: Height of the area to lay the bars out in.
+ * @param int bar_count: Number of visible bars.
+ */
+static void compute_layout(bars_layout_t *out, int screen_height, int bar_count) {
+	float height = (float)(screen_height - (bar_count + 1) * BAR_SPACING) / bar_count;
+
+	out->count = MIN(bar_count, MAX_VISIBLE_BARS);
+	for (int i = 0; i < out->count; ++i) {
+		out->y[i] = round(BAR_SPACING * (i + 1) + height * i);
+		out->height[i] = round(height);
+	}
+}
+
+/**
+ * Returns the height of the part of the screen not covered by the timeline 
+ * quick view, which is the whole screen on platforms without it.
+ *
+ * @return int: The unobstructed height.
+ */
+static int get_unobstructed_height() {
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+	if (layer_bars) {
+		return layer_get_unobstructed_bounds(layer_bars).size.h;
+	}
+#endif
+	return PBL_DISPLAY_HEIGHT;
+}
+
+/**
+ * Recalculates where the bars go based on the number of visible bars, for the 
+ * whole screen and, if the quick view is up, for the part it leaves uncovered.
+ */
+static void update_bar_positions() {
+	int bar_count = count_visible_bars();
+	compute_layout(&full_layout, PBL_DISPLAY_HEIGHT, bar_count);
+
+	int unobstructed_height = get_unobstructed_height();
+	if (unobstructed_height < PBL_DISPLAY_HEIGHT) {
+		compute_layout(&obstructed_layout, unobstructed_height, bar_count);
+		layout = obstructed_layout;
+	}
+	else {
+		layout = full_layout;
+	}
+
+	/* Any slide in progress was started from the old layout. */
+	layout_target = NULL;
 
-	/* Calculate the bar height based on the number of visible bars. */
-	int bar_count = count_enabled_bars(&settings);
-	bar_height = (float)(PBL_DISPLAY_HEIGHT - (bar_count + 1) * BAR_SPACING) / bar_count;
+	/* The cached sparkline has to be redrawn at the new height. */
+	sparkline_dirty = true;
+}
+
+/**
+ * Recalculates the bar positions and picks the font size based on the number 
+ * of visible bars.
+ */
+static void update_layout() {
+	update_bar_positions();
+
+	int bar_count = count_visible_bars();
 
 	/* Determine the correct font size (small, medium, or large). */
-	fonts_unload_custom_font(font_for_text);
 	if (bar_count <= 4) {
-		font_for_text = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_OXYGEN_MONO_27));
+		load_font(RESOURCE_ID_FONT_OXYGEN_MONO_27);
 	}
 	else if (bar_count <= 7) {
-		font_for_text = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_OXYGEN_MONO_20));
+		load_font(RESOURCE_ID_FONT_OXYGEN_MONO_20);
 	}
 	else {
-		font_for_text = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_OXYGEN_MONO_17));
+		load_font(RESOURCE_ID_FONT_OXYGEN_MONO_17);
 	}
+}
 
-	
-	/* Update subscription to battery state service. */
-	if (settings.show_bar[BATTERY_BAR_IDX]) {
-		battery_callback(battery_state_service_peek());
-		battery_state_service_subscribe(battery_callback);
+/**
+ * Handles all the updates needed when settigs are changed, such as 
+ * showing and hiding bars, updating supscriptions to event services 
+ * when those bars are turned on or off, changing the temperature display 
+ * from Fahrenheit to Celsius, etc. Only the parts affected by the
+ * changed fields are updated; anything else just needs a repaint.
+ *
+ * @param Win *win_main: Pointer to the main window. Needed to set the 
+ *	window background color.
+ * @param uint32_t changes: SETTINGS_CHANGED_* flags for the fields that changed.
+ *	SETTINGS_CHANGED_ALL brings everything up, e.g. at startup.
+ */
+static void settings_changed(Window *win_main, uint32_t changes) {
+	/* Pick the draw routine for the new style. */
+	if (changes & SETTINGS_CHANGED_BAR_STYLE) {
+		draw_bar = renderers_select(settings.bar_style);
 	}
-	else {
-		battery_state_service_unsubscribe();
+
+	/* The layout only depends on which bars are visible. */
+	if (changes & SETTINGS_CHANGED_ANY_SHOW_BAR) {
+		update_layout();
+	}
+
+	/* Update subscription to battery state service. */
+	if (changes & SETTINGS_CHANGED_SHOW_BAR(BATTERY_BAR_IDX)) {
+		if (settings.show_bar[BATTERY_BAR_IDX]) {
+			battery_callback(battery_state_service_peek());
+			battery_state_service_subscribe(battery_callback);
+		}
+		else {
+			battery_state_service_unsubscribe();
+		}
 	}
 
 	/* Update subscription to health tracking service. */
-	if (settings.show_bar[STEPS_BAR_IDX]) {
-		/* Initialize step count with saved value. */
-		if (persist_exists(STORAGE_KEY_STEPS)) {	
-			int saved_steps;
-			persist_read_data(STORAGE_KEY_STEPS, &saved_steps, sizeof(int));
-			update_steps(saved_steps);
+	if (changes & SETTINGS_CHANGED_SHOW_BAR(STEPS_BAR_IDX)) {
+		if (settings.show_bar[STEPS_BAR_IDX]) {
+			/* Initialize step count with saved value. */
+			if (persist_exists(STORAGE_KEY_STEPS)) {	
+				int saved_steps;
+				persist_read_data(STORAGE_KEY_STEPS, &saved_steps, sizeof(int));
+				update_steps(saved_steps);
+			}
+
+			health_service_events_subscribe(health_event_callback, NULL);
 		}
+		else {
+			health_service_events_unsubscribe();
+		}	
+	}
 
-		health_service_events_subscribe(health_event_callback, NULL);
+	/* The history is only kept while the sparkline is showing, so rebuild it 
+	when the sparkline is turned on. */
+	if (changes & (SETTINGS_CHANGED_SHOW_BAR(STEPS_BAR_IDX) | SETTINGS_CHANGED_STEPS_SPARKLINE)) {
+		step_history_reset();
+		if (settings.show_bar[STEPS_BAR_IDX] && settings.steps_sparkline) {
+			health_event_callback(HealthEventSignificantUpdate, NULL);
+		}
+		else if (sparkline_bitmap) {
+			gbitmap_destroy(sparkline_bitmap);
+			sparkline_bitmap = NULL;
+		}
 	}
-	else {
-		health_service_events_unsubscribe();
-	}	
 
-	/* Update subscription to tick timer service to use minutes or seconds. 
-	Subsequent calls override the previous subscription, so there is no 
-	need to explicilty unsubscribe from seconds, for instance. */
-	if (settings.show_bar[SECONDS_BAR_IDX])
-		tick_timer_service_subscribe(SECOND_UNIT, tick_handler);
-	else
-		tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
+	/* The cached sparkline has to be redrawn in the new color or size. */
+	if (changes & (SETTINGS_CHANGED_BAR_COLORS | SETTINGS_CHANGED_ANY_SHOW_BAR)) {
+		sparkline_dirty = true;
+	}
 
-	/* Force an update of all time units. */
-	time_t temp = time(NULL);
-	struct tm *tick_time = localtime(&temp);	
-	tick_handler(tick_time, SECOND_UNIT|MINUTE_UNIT|HOUR_UNIT|DAY_UNIT|MONTH_UNIT|YEAR_UNIT);
+	/* Update subscription to tick timer service to use minutes or seconds. */
+	if (changes & SETTINGS_CHANGED_SHOW_BAR(SECONDS_BAR_IDX)) {
+		subscribe_tick_timer();
+	}
+
+	/* Start or stop the background worker that keeps the step history while 
+	the watchface is not running. It is only needed while the sparkline is shown, 
+	and should not hold on to the watch's only worker slot otherwise. */
+	if (changes & (SETTINGS_CHANGED_BACKGROUND_WORKER | SETTINGS_CHANGED_STEPS_SPARKLINE | 
+				   SETTINGS_CHANGED_SHOW_BAR(STEPS_BAR_IDX))) {
+		bool worker_wanted = settings.background_worker && settings.show_bar[STEPS_BAR_IDX] && 
+			settings.steps_sparkline;
+
+		if (worker_wanted && !app_worker_is_running()) {
+			app_worker_launch();
+		}
+		else if (!worker_wanted && app_worker_is_running()) {
+			app_worker_kill();
+		}
+	}
+
+	/* Start or end quiet mode right away if its settings changed. */
+	if (changes & SETTINGS_CHANGED_QUIET_MODE) {
+		time_t temp = time(NULL);
+		update_quiet_mode(localtime(&temp));
+	}
+
+	/* Force an update of all time units if a time bar was turned on or off, 
+	since bars that are hidden are not kept up to date. The time bars are 
+	all the ones from hours through the combined month and day, plus daylight. */
+	uint32_t time_bars_changed = (SETTINGS_CHANGED_SHOW_BAR(COMBINED_MONTH_DAY_BAR_IDX + 1) 
+		- SETTINGS_CHANGED_SHOW_BAR(HOURS_BAR_IDX)) | SETTINGS_CHANGED_SHOW_BAR(DAYLIGHT_BAR_IDX);
+	if (changes & time_bars_changed) {
+		time_t temp = time(NULL);
+		struct tm *tick_time = localtime(&temp);	
+		tick_handler(tick_time, SECOND_UNIT|MINUTE_UNIT|HOUR_UNIT|DAY_UNIT|MONTH_UNIT|YEAR_UNIT);
+	}
+
+	/* The daylight bar needs a location, which comes with the weather. */
+	if ((changes & SETTINGS_CHANGED_SHOW_BAR(DAYLIGHT_BAR_IDX)) && 
+		settings.show_bar[DAYLIGHT_BAR_IDX] && !daylight_has_location()) {
+		fetch_weather();
+	}
 
 	/* Initialize temperature with saved value */
-	if (settings.show_bar[TEMPERATURE_BAR_IDX] && persist_exists(STORAGE_KEY_TEMPERATURE)) {	
-		int new_temperature;
-		persist_read_data(STORAGE_KEY_TEMPERATURE, &new_temperature, sizeof(int));
-		update_temperature(new_temperature);
-	}	
+	if (changes & (SETTINGS_CHANGED_SHOW_BAR(TEMPERATURE_BAR_IDX) | SETTINGS_CHANGED_TEMPERATURE)) {
+		if (settings.show_bar[TEMPERATURE_BAR_IDX] && persist_exists(STORAGE_KEY_TEMPERATURE)) {	
+			int new_temperature;
+			persist_read_data(STORAGE_KEY_TEMPERATURE, &new_temperature, sizeof(int));
+			update_temperature(new_temperature);
+		}	
+	}
 
 	/* Set the background color. */
-	window_set_background_color(win_main, settings.background_color);
+	if (changes & SETTINGS_CHANGED_BACKGROUND_COLOR) {
+		window_set_background_color(win_main, settings.background_color);
+	}
+
+	/* Trigger a redraw. Color and style changes need nothing more than this. */
+	layer_mark_dirty(layer_bars);
+}
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+/**
+ * UnobstructedAreaWillChangeHandler called before the timeline quick view starts 
+ * sliding in or out. Picks the layout the bars will end up in, so that each frame 
+ * of the slide only has to move them part of the way there.
+ *
+ * @param GRect final_unobstructed_screen_area: The uncovered area once the slide ends.
+ * @param void *context: Pointer to application data.
+ */
+static void unobstructed_will_change(GRect final_unobstructed_screen_area, void *context) {
+	layout_start = layout;
+
+	if (final_unobstructed_screen_area.size.h < PBL_DISPLAY_HEIGHT) {
+		compute_layout(&obstructed_layout, final_unobstructed_screen_area.size.h, full_layout.count);
+		layout_target = &obstructed_layout;
+	}
+	else {
+		layout_target = &full_layout;
+	}
+}
+
+/**
+ * UnobstructedAreaChangeHandler called for each frame of the slide. Moves the 
+ * bars between the starting and final layouts, in integer math only, without 
+ * touching the fonts or the settings.
+ *
+ * @param AnimationProgress progress: How far along the slide is, up to ANIMATION_NORMALIZED_MAX.
+ * @param void *context: Pointer to application data.
+ */
+static void unobstructed_change(AnimationProgress progress, void *context) {
+	if (!layout_target) {
+		return;
+	}
+
+	for (int i = 0; i < layout.count; ++i) {
+		layout.y[i] = layout_start.y[i] + 
+			(layout_target->y[i] - layout_start.y[i]) * progress / ANIMATION_NORMALIZED_MAX;
+		layout.height[i] = layout_start.height[i] + 
+			(layout_target->height[i] - layout_start.height[i]) * progress / ANIMATION_NORMALIZED_MAX;
+	}
 
-	/* Trigger a redraw. */
 	layer_mark_dirty(layer_bars);
 }
 
+/**
+ * UnobstructedAreaDidChangeHandler called once the slide has ended. Settles 
+ * on the final layout, recalculating it if the bars changed during the slide.
+ *
+ * @param void *context: Pointer to application data.
+ */
+static void unobstructed_did_change(void *context) {
+	if (layout_target) {
+		layout = *layout_target;
+		layout_target = NULL;
+		sparkline_dirty = true;
+	}
+	else {
+		update_bar_positions();
+	}
+
+	layer_mark_dirty(layer_bars);
+}
+#endif
+
+/**
+ * Restores the last rendered state from the snapshot in persistent storage, so
+ * that the first frame can be drawn without waiting on any of the services.
+ * The snapshot is only used if its layout matches the current settings.
+ *
+ * @return bool: True if the snapshot was restored.
+ */
+static bool restore_snapshot() {
+	if (!persist_exists(STORAGE_KEY_SNAPSHOT)) {
+		return false;
+	}
+
+	bars_snapshot_t snapshot;
+	persist_read_data(STORAGE_KEY_SNAPSHOT, &snapshot, sizeof(bars_snapshot_t));
+
+	if (snapshot.version != SNAPSHOT_VERSION || 
+		snapshot.shown_bars != get_shown_bars()) {
+		APP_LOG(APP_LOG_LEVEL_INFO, "Saved snapshot does not match the settings; ignoring it.");
+		return false;
+	}
+
+	update_layout();
+	memcpy(progress, snapshot.progress, sizeof(progress));
+	memcpy(labels, snapshot.labels, sizeof(labels));
+
+	return true;
+}
+
+/**
+ * Saves the state currently on screen as the snapshot for the next launch.
+ */
+static void save_snapshot() {
+	bars_snapshot_t snapshot = {
+		.version = SNAPSHOT_VERSION,
+		.shown_bars = get_shown_bars()
+	};
+	memcpy(snapshot.progress, progress, sizeof(progress));
+	memcpy(snapshot.labels, labels, sizeof(labels));
+
+	persist_write_data(STORAGE_KEY_SNAPSHOT, &snapshot, sizeof(bars_snapshot_t));
+}
+
+/**
+ * AppTimerCallback that finishes starting up after the first frame was drawn from 
+ * the snapshot: subscribes to the services and brings every bar up to date.
+ *
+ * @param void *context: Pointer to the main window.
+ */
+static void complete_startup(void *context) {
+	settings_changed((Window *) context, SETTINGS_CHANGED_ALL);
+}
+
+/**
+ * Called once the first frame has been drawn. Logs the time-to-first-frame 
+ * and, if startup was deferred until now, schedules the rest of it.
+ */
+static void first_frame_done() {
+	time_t now_s;
+	uint16_t now_ms;
+	time_ms(&now_s, &now_ms);
+	int elapsed_ms = (now_s - launch_time_s) * 1000 + now_ms - launch_time_ms;
+
+	APP_LOG(APP_LOG_LEVEL_INFO, "First frame drawn %d ms after launch (%s).", elapsed_ms,
+			startup_window ? "from snapshot" : "full startup");
+
+	if (startup_window) {
+		app_timer_register(0, complete_startup, startup_window);
+		startup_window = NULL;
+	}
+}
+
 /*** External Functions ***/
 
 /**
@@ -389,30 +1090,52 @@ static void settings_changed(Window *win_main) {
  * @param Window* win_main: Pointer to the main window.
  */
 void bars_init(Window *win_main) {
-	/* Allocate memory for label strings. */
-	for (int i = 0; i < TOTAL_BARS; ++i) {
-		labels[i] = malloc(LABEL_WIDTH);
-	}
+	time_ms(&launch_time_s, &launch_time_ms);
 
-	/* Load the settings, either from storage or from defaults. */
+	/* Load the settings, either from storage or from defaults, along with 
+	the metrics last pushed by the phone and the cached location. */
 	load_settings(&settings);
-	settings_changed(win_main);
+	remote_metrics_load();
+	daylight_load();
 
-	/* Start timer to fetch weather periodically. */
-	app_timer_register(WEATHER_UPDATE_FREQUENCY_MS, fetch_weather_timer, NULL);
+	/* Draw the first frame from the snapshot if there is one; the services are 
+	brought up once it is on screen. Otherwise, do the full startup now. */
+	if (restore_snapshot()) {
+		startup_window = win_main;
+		window_set_background_color(win_main, settings.background_color);
+		draw_bar = renderers_select(settings.bar_style);
+
+		/* The time bars are cheap to bring up to date and would otherwise show 
+		the time at which the snapshot was taken. This also marks the layer dirty. */
+		time_t temp = time(NULL);
+		tick_handler(localtime(&temp), SECOND_UNIT|MINUTE_UNIT|HOUR_UNIT|DAY_UNIT|MONTH_UNIT|YEAR_UNIT);
+	}
+	else {
+		settings_changed(win_main, SETTINGS_CHANGED_ALL);
+	}
+
+	/* Start timer to fetch weather periodically. If the weather is already due, 
+	it is fetched once the phone says it is ready instead (see 
+	bars_handle_phone_ready), since a request sent before then would be lost. */
+	int weather_delay_ms = get_weather_due_ms();
+	app_timer_register(weather_delay_ms > 0 ? weather_delay_ms : WEATHER_UPDATE_FREQUENCY_MS, 
+					   fetch_weather_timer, NULL);
 }
 
 /**
  * Deallocates data and unloads resources.
  */
 void bars_deinit() {
+	/* Keep what is on screen for the next launch. */
+	save_snapshot();
+
 	/* Unload resources. */
 	fonts_unload_custom_font(font_for_text);
-
-	/* Deallocate memory for label strings. */
-	for (int i = 0; i < TOTAL_BARS; ++i) {
-		free(labels[i]);
+	if (sparkline_bitmap) {
+		gbitmap_destroy(sparkline_bitmap);
 	}
+
+	outbox_deinit();
 }
 
 /**
@@ -423,6 +1146,16 @@ void bars_deinit() {
 Layer* bars_create_layer() {
 	layer_bars = layer_create(GRect(0,0, PBL_DISPLAY_WIDTH,PBL_DISPLAY_HEIGHT));
 	layer_set_update_proc(layer_bars, redraw_bars);	
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+	/* Fit the bars into the part of the screen left by the timeline quick view. */
+	unobstructed_area_service_subscribe((UnobstructedAreaHandlers) {
+		.will_change = unobstructed_will_change,
+		.change = unobstructed_change,
+		.did_change = unobstructed_did_change
+	}, NULL);
+#endif
+
 	return layer_bars;
 }
 
@@ -432,6 +1165,9 @@ Layer* bars_create_layer() {
  * as it is stored statically.
  */
 void bars_destroy_layer() {
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+	unobstructed_area_service_unsubscribe();
+#endif
 	layer_destroy(layer_bars);
 }
 
@@ -449,15 +1185,89 @@ void bars_handle_temperature_received(int new_temperature) {
 	or when the bar is truned on, thus avoiding having a blank display while waiting 
 	for the first response. */
 	persist_write_data(STORAGE_KEY_TEMPERATURE, &new_temperature, sizeof(int));
+	persist_write_int(STORAGE_KEY_WEATHER_TIME, time(NULL));
 }
 
 /**
- * Reads and stores settings when received from the app message.
+ * Fetches the weather when the phone is ready to receive messages, if it is due.
+ * This is what brings the weather up to date after a launch.
+ */
+void bars_handle_phone_ready() {
+	if (needs_weather() && !quiet && get_weather_due_ms() == 0) {
+		fetch_weather();
+	}
+}
+
+/**
+ * Caches the location received with the weather, and recalculates today's 
+ * sunrise and sunset if it has moved.
  *
- * @param int new_temperature: The new temperature value in Fahrenheit.
+ * @param int32_t latitude_x100: Latitude in hundredths of a degree.
+ * @param int32_t longitude_x100: Longitude in hundredths of a degree.
  */
-void bars_handle_settings_received(DictionaryIterator *it, Window* win_main) {
-	read_settings_from_app_message(&settings, it);
-	settings_changed(win_main);
+void bars_handle_location_received(int32_t latitude_x100, int32_t longitude_x100) {
+	if (!daylight_set_location(latitude_x100, longitude_x100) || !settings.show_bar[DAYLIGHT_BAR_IDX]) {
+		return;
+	}
+
+	time_t temp = time(NULL);
+	struct tm *tick_time = localtime(&temp);
+	todays_daylight = daylight_update(tick_time, true);
+	update_daylight(tick_time);
+	layer_mark_dirty(layer_bars);
+}
+
+/**
+ * Returns the settings currently in use, for building new ones from an app message.
+ *
+ * @return const app_settings_t*: The current settings.
+ */
+const app_settings_t* bars_get_settings() {
+	return &settings;
+}
+
+/**
+ * Stores settings when received from the app message.
+ * Only what the changed fields affect is updated, and nothing is
+ * saved if the settings are the same as before.
+ *
+ * @param const app_settings_t *new_settings: The settings read from the app message.
+ * @param Window *win_main: Pointer to the main window.
+ */
+void bars_handle_settings_received(const app_settings_t *new_settings, Window* win_main) {
+	uint32_t changes = diff_settings(&settings, new_settings);
+	if (changes == SETTINGS_CHANGED_NONE) {
+		APP_LOG(APP_LOG_LEVEL_INFO, "Received settings are unchanged.");
+		return;
+	}
+
+	settings = *new_settings;
+
+	/* Turn the light on briefly to highlight the new display. */
+	light_enable_interaction();
+
+	settings_changed(win_main, changes);
 	save_settings(&settings);
 }
+
+
+/**
+ * Updates the phone-pushed metric bars when a frame of them is received 
+ * from the app message. The layout is only redone if metrics were added or removed.
+ *
+ * @param const uint8_t *data: The frame of metric updates.
+ * @param uint16_t length: Length of the frame in bytes.
+ */
+void bars_handle_remote_metrics_received(const uint8_t *data, uint16_t length) {
+	remote_metrics_result_e result = remote_metrics_decode(data, length);
+	if (result == REMOTE_METRICS_UNCHANGED) {
+		return;
+	}
+
+	if (result == REMOTE_METRICS_LAYOUT_CHANGED) {
+		update_layout();
+	}
+
+	remote_metrics_save();
+	layer_mark_dirty(layer_bars);
+}
\ No newline at end of file
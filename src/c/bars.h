@@ -2,6 +2,11 @@
 
 #include <math.h>
 #include "configuration.h"
+#include "daylight.h"
+#include "outbox.h"
+#include "remote_metrics.h"
+#include "renderers.h"
+#include "step_history.h"
 #include "utilities.h"
 
 #ifndef PBL_DISPLAY_WIDTH
@@ -18,4 +23,8 @@ void bars_deinit();
 Layer* bars_create_layer();
 void bars_destroy_layer();
 void bars_handle_temperature_received(int new_temperature);
-void bars_handle_settings_received(DictionaryIterator *it, Window* win_main);
+void bars_handle_phone_ready();
+void bars_handle_location_received(int32_t latitude_x100, int32_t longitude_x100);
+const app_settings_t* bars_get_settings();
+void bars_handle_settings_received(const app_settings_t *new_settings, Window* win_main);
+void bars_handle_remote_metrics_received(const uint8_t *data, uint16_t length);
@@ -3,7 +3,7 @@
 #include "configuration.h"
 
 /*** Constants ***/
-const int CURRENT_SCHEMA_VERSION = 5;
+const int CURRENT_SCHEMA_VERSION = 9;
 
 /*** Internal Functions ***/
 
@@ -19,20 +19,23 @@ static void load_default_settings(app_settings_t *settings) {
 	settings->text_outline_color = GColorBlack;
 	
 	/* Set the default bar colors depending on whether the watch is color or black and white. 
-	These should match the defaults set in claylayout.js. */
+	On black and white, the bars alternate between white and light gray, which is drawn 
+	dithered. These should match the defaults set in claylayout.js. */
 	settings->bar_colors[HOURS_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorOxfordBlue, GColorWhite);
-	settings->bar_colors[MINUTES_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorDukeBlue, GColorWhite);
+	settings->bar_colors[MINUTES_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorDukeBlue, GColorLightGray);
 	settings->bar_colors[COMBINED_HOURS_MINUTES_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorDukeBlue, GColorWhite);
-	settings->bar_colors[SECONDS_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorVividCerulean, GColorWhite);
+	settings->bar_colors[SECONDS_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorVividCerulean, GColorLightGray);
 	settings->bar_colors[WEEKDAY_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorRajah, GColorWhite);
-	settings->bar_colors[MONTH_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorSpringBud, GColorWhite);
+	settings->bar_colors[MONTH_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorSpringBud, GColorLightGray);
 	settings->bar_colors[DAY_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorYellow, GColorWhite);
-	settings->bar_colors[COMBINED_MONTH_DAY_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorYellow, GColorWhite);
+	settings->bar_colors[COMBINED_MONTH_DAY_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorYellow, GColorLightGray);
 	settings->bar_colors[TEMPERATURE_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorImperialPurple, GColorWhite);
-	settings->bar_colors[STEPS_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorDarkGreen, GColorWhite);
+	settings->bar_colors[STEPS_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorDarkGreen, GColorLightGray);
 	settings->bar_colors[BATTERY_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorRed, GColorWhite);
+	settings->bar_colors[DAYLIGHT_BAR_IDX] = PBL_IF_COLOR_ELSE(GColorChromeYellow, GColorLightGray);
 	
-	/* Default display settings: show all bars with hours/mins and month/day combined. */
+	/* Default display settings: show all bars with hours/mins and month/day combined, 
+	except for daylight. */
 	settings->show_bar[HOURS_BAR_IDX] = false;
 	settings->show_bar[MINUTES_BAR_IDX] = false;
 	settings->show_bar[COMBINED_HOURS_MINUTES_BAR_IDX] = true;
@@ -44,56 +47,159 @@ static void load_default_settings(app_settings_t *settings) {
 	settings->show_bar[TEMPERATURE_BAR_IDX] = true;
 	settings->show_bar[STEPS_BAR_IDX] = true;	
 	settings->show_bar[BATTERY_BAR_IDX] = true;
+	settings->show_bar[DAYLIGHT_BAR_IDX] = false;
 	
 	settings->temperature_scale = FAHRENHEIT;
 	settings->temperature_min = 32;		
 	settings->temperature_max = 100;
 	
 	settings->bar_style = SOLID;
+	
+	settings->steps_sparkline = false;
+	
+	/* Default quiet mode: only while the user is asleep. */
+	settings->quiet_mode_sleep = true;
+	settings->quiet_mode_window = false;
+	settings->quiet_start_hour = 23;
+	settings->quiet_end_hour = 7;
+	
+	/* The worker is opt-in, since only one app's worker can run at a time. */
+	settings->background_worker = false;
 }
 
 /**
- * Reads a value from the dictionary into the passed boolean.
+ * Reads a settings tuple into the passed boolean.
  * 
- * @param DictionaryIterator *it: Iterator for the app message with the settings.
- * @param uint32_t message_key: Message key for the settings to be read.
+ * @param const Tuple *tuple: The tuple with the setting.
  * @param bool *setting: Variable to hold the value.
  */
-static void read_setting_bool (DictionaryIterator *it, uint32_t message_key, bool *setting) {
-	Tuple *setting_tuple = dict_find(it, message_key);
-	if(setting_tuple) {
-		*setting = (setting_tuple->value->int16 == 1);
-	}
+static void read_setting_bool(const Tuple *tuple, bool *setting) {
+	*setting = (tuple->value->int16 == 1);
 }
 
 /**
- * Reads a value from the dictionary into the passed GColor.
+ * Reads a settings tuple into the passed GColor.
  * 
- * @param DictionaryIterator *it: Iterator for the app message with the settings.
- * @param uint32_t message_key: Message key for the settings to be read.
+ * @param const Tuple *tuple: The tuple with the setting.
  * @param GColor *setting: Variable to hold the value.
  */
-static void read_setting_gcolor (DictionaryIterator *it, uint32_t message_key, GColor *setting) {
-	Tuple *setting_tuple = dict_find(it, message_key);
-	if(setting_tuple) {
-		*setting = GColorFromHEX(setting_tuple->value->int32);
+static void read_setting_gcolor(const Tuple *tuple, GColor *setting) {
+	*setting = GColorFromHEX(tuple->value->int32);
+}
+
+/*** Setting Readers ***/
+
+/* Each reader decodes one settings tuple into the settings being built. The 
+index is the tuple's position within its key range, e.g. which bar it is for. */
+
+static void read_background_color(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_gcolor(tuple, &(reader->settings.background_color));
+}
+
+static void read_text_color(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_gcolor(tuple, &(reader->settings.text_color));
+}
+
+static void read_text_outline_color(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_gcolor(tuple, &(reader->settings.text_outline_color));
+}
+
+static void read_bar_checkbox(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_bool(tuple, &(reader->settings.show_bar[index]));
+}
+
+static void read_bar_color(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_gcolor(tuple, &(reader->settings.bar_colors[index]));
+}
+
+static void read_temperature_scale(settings_reader_t *reader, const Tuple *tuple, int index) {
+	if (tuple->value->cstring[0] == 'C') {
+		reader->settings.temperature_scale = CELSIUS;
+	}
+	else if (tuple->value->cstring[0] == 'F') {
+		reader->settings.temperature_scale = FAHRENHEIT;
+	}
+	else {
+		APP_LOG(APP_LOG_LEVEL_ERROR, "Invalid value for MESSAGE_KEY_TemperatureScale: %s.", 
+				tuple->value->cstring);
 	}
 }
 
-/**
- * Reads a value from the dictionary into the passed int.		
- * 		
- * @param DictionaryIterator *it: Iterator for the app message with the settings.		
- * @param uint32_t message_key: Message key for the settings to be read.		
- * @param int *setting: Variable to hold the value.		
- */		
-static void read_setting_int (DictionaryIterator *it, uint32_t message_key, int *setting) {		
-	Tuple *setting_tuple = dict_find(it, message_key);		
-	if(setting_tuple) {		
-		*setting = setting_tuple->value->int32;
-	}		
+/* The bounds depend on the scale, which may come later in the message, so 
+they are only kept until settings_reader_finish. */
+static void read_temperature_bound(settings_reader_t *reader, const Tuple *tuple, int index) {
+	reader->temperature_bounds[index] = tuple;
+}
+
+static void read_bar_style(settings_reader_t *reader, const Tuple *tuple, int index) {
+	if (tuple->value->cstring[0] == 'S') {
+		reader->settings.bar_style = SOLID;
+	}
+	else if (tuple->value->cstring[0] == 'O') {
+		reader->settings.bar_style = OUTLINE;
+	}
+	else {
+		APP_LOG(APP_LOG_LEVEL_ERROR, "Invalid value for MESSAGE_KEY_BarStyle: %s.", 
+				tuple->value->cstring);
+	}
+}
+
+static void read_steps_sparkline(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_bool(tuple, &(reader->settings.steps_sparkline));
+}
+
+static void read_quiet_mode_sleep(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_bool(tuple, &(reader->settings.quiet_mode_sleep));
+}
+
+static void read_quiet_mode_window(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_bool(tuple, &(reader->settings.quiet_mode_window));
+}
+
+static void read_quiet_start_hour(settings_reader_t *reader, const Tuple *tuple, int index) {
+	reader->settings.quiet_start_hour = tuple->value->int32;
 }
 
+static void read_quiet_end_hour(settings_reader_t *reader, const Tuple *tuple, int index) {
+	reader->settings.quiet_end_hour = tuple->value->int32;
+}
+
+static void read_background_worker(settings_reader_t *reader, const Tuple *tuple, int index) {
+	read_setting_bool(tuple, &(reader->settings.background_worker));
+}
+
+/**
+ * Which reader handles each range of message keys. Array settings such as 
+ * the bar checkboxes take one key per bar, starting at their first key. Entries 
+ * with a count of 1 pass their base as the index.
+ */
+typedef struct {
+	const uint32_t *first_key;
+	int count;
+	int base;
+	setting_reader_fn read;
+} setting_key_range_t;
+
+static const setting_key_range_t SETTING_KEY_RANGES[] = {
+	{ &MESSAGE_KEY_BarCheckboxes, TOTAL_BARS, 0, read_bar_checkbox },
+	{ &MESSAGE_KEY_BarColors, TOTAL_BARS, 0, read_bar_color },
+	{ &MESSAGE_KEY_BackgroundColor, 1, 0, read_background_color },
+	{ &MESSAGE_KEY_TextColor, 1, 0, read_text_color },
+	{ &MESSAGE_KEY_TextOutlineColor, 1, 0, read_text_outline_color },
+	{ &MESSAGE_KEY_TemperatureScale, 1, 0, read_temperature_scale },
+	{ &MESSAGE_KEY_TemperatureMinF, 1, TEMPERATURE_MIN_F, read_temperature_bound },
+	{ &MESSAGE_KEY_TemperatureMaxF, 1, TEMPERATURE_MAX_F, read_temperature_bound },
+	{ &MESSAGE_KEY_TemperatureMinC, 1, TEMPERATURE_MIN_C, read_temperature_bound },
+	{ &MESSAGE_KEY_TemperatureMaxC, 1, TEMPERATURE_MAX_C, read_temperature_bound },
+	{ &MESSAGE_KEY_BarStyle, 1, 0, read_bar_style },
+	{ &MESSAGE_KEY_StepsSparkline, 1, 0, read_steps_sparkline },
+	{ &MESSAGE_KEY_QuietModeSleep, 1, 0, read_quiet_mode_sleep },
+	{ &MESSAGE_KEY_QuietModeWindow, 1, 0, read_quiet_mode_window },
+	{ &MESSAGE_KEY_QuietStartHour, 1, 0, read_quiet_start_hour },
+	{ &MESSAGE_KEY_QuietEndHour, 1, 0, read_quiet_end_hour },
+	{ &MESSAGE_KEY_BackgroundWorker, 1, 0, read_background_worker }
+};
+
 /*** External Functions ***/
 
 /**
@@ -137,60 +243,66 @@ void save_settings(app_settings_t *settings) {
 }
 
 /**
- * Parses the dictionary in the app message into the settings.
+ * Starts reading settings from an app message on top of the current ones, 
+ * so that settings missing from the message keep their value.
  *
- * @param app_settings_t *settings: Struct to hold the settings.
- & @param DictionaryIterator *it: Iterator for the app message with the settings.
+ * @param settings_reader_t *reader: The reader to set up.
+ * @param const app_settings_t *current_settings: The settings currently in use.
  */
-void read_settings_from_app_message(app_settings_t *settings, DictionaryIterator *it) {
-	/* Read the colors settings. */
-	read_setting_gcolor(it, MESSAGE_KEY_BackgroundColor, &(settings->background_color));
-	read_setting_gcolor(it, MESSAGE_KEY_TextColor, &(settings->text_color));
-	read_setting_gcolor(it, MESSAGE_KEY_TextOutlineColor, &(settings->text_outline_color));
-	
-	/* Loop to read whether each bar is enabled and read the color. */
-	for (int i = 0; i < TOTAL_BARS; ++i) {
-		read_setting_bool(it, MESSAGE_KEY_BarCheckboxes + i, &(settings->show_bar[i]));
-		read_setting_gcolor(it, MESSAGE_KEY_BarColors + i, &(settings->bar_colors[i]));
+void settings_reader_init(settings_reader_t *reader, const app_settings_t *current_settings) {
+	reader->settings = *current_settings;
+	for (int i = 0; i < TEMPERATURE_BOUNDS; ++i) {
+		reader->temperature_bounds[i] = NULL;
 	}
-	
-	Tuple *temperature_scale_tuple = dict_find(it, MESSAGE_KEY_TemperatureScale);
-	if(temperature_scale_tuple) {
-		if (temperature_scale_tuple->value->cstring[0] == 'C') {
-			settings->temperature_scale = CELSIUS;
-		}
-		else if (temperature_scale_tuple->value->cstring[0] == 'F') {
-			settings->temperature_scale = FAHRENHEIT;
-		}
-		else {
-			APP_LOG(APP_LOG_LEVEL_ERROR, "Invalid value for MESSAGE_KEY_TemperatureScale: %s.", 
-					temperature_scale_tuple->value->cstring);
+}
+
+/**
+ * Decodes a single tuple of an app message into the settings, if it holds one.
+ * The tuple is decoded in place; nothing is copied out of the message.
+ *
+ * @param settings_reader_t *reader: The reader the settings are being built in.
+ * @param const Tuple *tuple: The tuple to decode.
+ * @return bool: Whether the tuple was a setting.
+ */
+bool settings_reader_read(settings_reader_t *reader, const Tuple *tuple) {
+	for (unsigned int i = 0; i < ARRAY_LENGTH(SETTING_KEY_RANGES); ++i) {
+		const setting_key_range_t *range = &SETTING_KEY_RANGES[i];
+		/* Unsigned, so keys below the start of the range wrap around and fail the check. */
+		uint32_t offset = tuple->key - *(range->first_key);
+		if (offset < (uint32_t) range->count) {
+			range->read(reader, tuple, range->base + offset);
+			return true;
 		}
 	}
 	
-	/* Read the correct temperature bounds, either C or F depending on what the user chose. */
-	if (settings->temperature_scale == FAHRENHEIT) {		
-		read_setting_int(it, MESSAGE_KEY_TemperatureMinF, &(settings->temperature_min));		
-		read_setting_int(it, MESSAGE_KEY_TemperatureMaxF, &(settings->temperature_max));			
-	}		
-	else if (settings->temperature_scale == CELSIUS) {		
-		read_setting_int(it, MESSAGE_KEY_TemperatureMinC, &(settings->temperature_min));		
-		read_setting_int(it, MESSAGE_KEY_TemperatureMaxC, &(settings->temperature_max));			
-	}	
-	
-	Tuple *bar_style_tuple = dict_find(it, MESSAGE_KEY_BarStyle);
-	if(bar_style_tuple) {
-		if (bar_style_tuple->value->cstring[0] == 'S') {
-			settings->bar_style = SOLID;
-		}
-		else if (bar_style_tuple->value->cstring[0] == 'O') {
-			settings->bar_style = OUTLINE;
-		}
-		else {
-			APP_LOG(APP_LOG_LEVEL_ERROR, "Invalid value for MESSAGE_KEY_BarStyle: %s.", 
-					bar_style_tuple->value->cstring);
-		}
-	}	
+	return false;
+}
+
+/**
+ * Resolves the settings that depend on others once every tuple has been read.
+ * Only the temperature bounds for the chosen scale are used.
+ *
+ * @param settings_reader_t *reader: The reader the settings were built in.
+ */
+void settings_reader_finish(settings_reader_t *reader) {
+	const Tuple *min_tuple;
+	const Tuple *max_tuple;
+	
+	if (reader->settings.temperature_scale == FAHRENHEIT) {
+		min_tuple = reader->temperature_bounds[TEMPERATURE_MIN_F];
+		max_tuple = reader->temperature_bounds[TEMPERATURE_MAX_F];
+	}
+	else {
+		min_tuple = reader->temperature_bounds[TEMPERATURE_MIN_C];
+		max_tuple = reader->temperature_bounds[TEMPERATURE_MAX_C];
+	}
+	
+	if (min_tuple) {
+		reader->settings.temperature_min = min_tuple->value->int32;
+	}
+	if (max_tuple) {
+		reader->settings.temperature_max = max_tuple->value->int32;
+	}
 }
 
 /**
@@ -209,3 +321,61 @@ int count_enabled_bars(app_settings_t *settings) {
 	
 	return count;
 }
+
+
+/**
+ * Compares two settings structs field by field.
+ * 
+ * @param app_settings_t *old_settings: The settings currently in use.
+ * @param app_settings_t *new_settings: The settings to compare them against.
+ * @return uint32_t: SETTINGS_CHANGED_* flags for each field that differs, 
+ *	or SETTINGS_CHANGED_NONE if they are the same.
+ */
+uint32_t diff_settings(const app_settings_t *old_settings, const app_settings_t *new_settings) {
+	uint32_t changes = SETTINGS_CHANGED_NONE;
+
+	if (!gcolor_equal(old_settings->background_color, new_settings->background_color)) {
+		changes |= SETTINGS_CHANGED_BACKGROUND_COLOR;
+	}
+	
+	if (!gcolor_equal(old_settings->text_color, new_settings->text_color) ||
+		!gcolor_equal(old_settings->text_outline_color, new_settings->text_outline_color)) {
+		changes |= SETTINGS_CHANGED_TEXT_COLORS;
+	}
+	
+	for (int i = 0; i < TOTAL_BARS; ++i) {
+		if (!gcolor_equal(old_settings->bar_colors[i], new_settings->bar_colors[i])) {
+			changes |= SETTINGS_CHANGED_BAR_COLORS;
+		}
+		if (old_settings->show_bar[i] != new_settings->show_bar[i]) {
+			changes |= SETTINGS_CHANGED_SHOW_BAR(i);
+		}
+	}
+	
+	if (old_settings->bar_style != new_settings->bar_style) {
+		changes |= SETTINGS_CHANGED_BAR_STYLE;
+	}
+	
+	if (old_settings->temperature_scale != new_settings->temperature_scale ||
+		old_settings->temperature_min != new_settings->temperature_min ||
+		old_settings->temperature_max != new_settings->temperature_max) {
+		changes |= SETTINGS_CHANGED_TEMPERATURE;
+	}
+	
+	if (old_settings->steps_sparkline != new_settings->steps_sparkline) {
+		changes |= SETTINGS_CHANGED_STEPS_SPARKLINE;
+	}
+	
+	if (old_settings->quiet_mode_sleep != new_settings->quiet_mode_sleep ||
+		old_settings->quiet_mode_window != new_settings->quiet_mode_window ||
+		old_settings->quiet_start_hour != new_settings->quiet_start_hour ||
+		old_settings->quiet_end_hour != new_settings->quiet_end_hour) {
+		changes |= SETTINGS_CHANGED_QUIET_MODE;
+	}
+	
+	if (old_settings->background_worker != new_settings->background_worker) {
+		changes |= SETTINGS_CHANGED_BACKGROUND_WORKER;
+	}
+	
+	return changes;
+}
\ No newline at end of file
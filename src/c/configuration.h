@@ -9,7 +9,12 @@ enum {
 	STORAGE_KEY_VERSION,
 	STORAGE_KEY_SETTINGS,
 	STORAGE_KEY_TEMPERATURE,
-	STORAGE_KEY_STEPS
+	STORAGE_KEY_STEPS,
+	STORAGE_KEY_SNAPSHOT,
+	STORAGE_KEY_REMOTE_METRICS,
+	STORAGE_KEY_LOCATION,
+	STORAGE_KEY_DAYLIGHT,
+	STORAGE_KEY_WEATHER_TIME
 };
 
 /**
@@ -27,6 +32,7 @@ enum {
 	TEMPERATURE_BAR_IDX,
 	STEPS_BAR_IDX,
 	BATTERY_BAR_IDX,
+	DAYLIGHT_BAR_IDX,
 	TOTAL_BARS
 };
 
@@ -46,6 +52,28 @@ typedef enum {
 	OUTLINE
 } bar_style_e;
 
+/**
+ * Flags describing which fields differ between two settings structs.
+ * Each bar's show_bar flag has its own bit, given by SETTINGS_CHANGED_SHOW_BAR.
+ */
+enum {
+	SETTINGS_CHANGED_NONE = 0,
+	SETTINGS_CHANGED_BACKGROUND_COLOR = 1 << 0,
+	SETTINGS_CHANGED_TEXT_COLORS = 1 << 1,
+	SETTINGS_CHANGED_BAR_COLORS = 1 << 2,
+	SETTINGS_CHANGED_BAR_STYLE = 1 << 3,
+	SETTINGS_CHANGED_TEMPERATURE = 1 << 4,
+	SETTINGS_CHANGED_STEPS_SPARKLINE = 1 << 5,
+	SETTINGS_CHANGED_QUIET_MODE = 1 << 6,
+	SETTINGS_CHANGED_BACKGROUND_WORKER = 1 << 7
+};
+
+#define SETTINGS_CHANGED_ALL UINT32_MAX
+
+#define SETTINGS_CHANGED_SHOW_BAR_SHIFT 8
+#define SETTINGS_CHANGED_SHOW_BAR(idx) (1 << (SETTINGS_CHANGED_SHOW_BAR_SHIFT + (idx)))
+#define SETTINGS_CHANGED_ANY_SHOW_BAR (((1 << TOTAL_BARS) - 1) << SETTINGS_CHANGED_SHOW_BAR_SHIFT)
+
 /**
  * Holds all the user settings for the app.
  */
@@ -59,10 +87,41 @@ typedef struct {
 	bar_style_e bar_style;
 	int temperature_min;		
 	int temperature_max;	
+	bool steps_sparkline;
+	bool quiet_mode_sleep;
+	bool quiet_mode_window;
+	int quiet_start_hour;
+	int quiet_end_hour;
+	bool background_worker;
 } app_settings_t;
 
+/**
+ * Temperature bounds sent by the config page, one pair for each scale.
+ */
+enum {
+	TEMPERATURE_MIN_F,
+	TEMPERATURE_MAX_F,
+	TEMPERATURE_MIN_C,
+	TEMPERATURE_MAX_C,
+	TEMPERATURE_BOUNDS
+};
+
+/**
+ * Builds new settings from the tuples of an app message, one tuple at a time. 
+ * The temperature bounds point into the message until the scale is known.
+ */
+typedef struct {
+	app_settings_t settings;
+	const Tuple *temperature_bounds[TEMPERATURE_BOUNDS];
+} settings_reader_t;
+
+typedef void (*setting_reader_fn)(settings_reader_t *reader, const Tuple *tuple, int index);
+
 /*** Functions ***/
 void load_settings(app_settings_t *settings);
-void read_settings_from_app_message(app_settings_t *settings, DictionaryIterator *it);
+void settings_reader_init(settings_reader_t *reader, const app_settings_t *current_settings);
+bool settings_reader_read(settings_reader_t *reader, const Tuple *tuple);
+void settings_reader_finish(settings_reader_t *reader);
 void save_settings(app_settings_t *settings);
 int count_enabled_bars(app_settings_t *settings);
+uint32_t diff_settings(const app_settings_t *old_settings, const app_settings_t *new_settings);
@@ -0,0 +1,216 @@
+#include <pebble.h>
+#include "configuration.h"
+#include "daylight.h"
+
+/*** Constants ***/
+
+/* Sine of the sun's altitude at sunrise and sunset (-0.833 degrees, which accounts 
+for refraction and the size of the sun's disc), as a fraction of TRIG_MAX_RATIO. */
+const int32_t SIN_SUNRISE_ALTITUDE = -953;
+
+/* Locations closer than this to the cached one, in hundredths of a degree, 
+do not change the times by enough to be worth recomputing them. */
+const int32_t LOCATION_THRESHOLD_X100 = 10;
+
+const int DAYLIGHT_MINUTES_PER_DAY = 24 * 60;
+
+/*** Types ***/
+
+/**
+ * The location used for the calculation, in hundredths of a degree.
+ */
+typedef struct {
+	int32_t latitude_x100;
+	int32_t longitude_x100;
+} location_t;
+
+/*** Internal Global Variables ***/
+static location_t location;
+static bool location_known;
+static daylight_t cached_daylight;
+
+/*** Internal Functions ***/
+
+/**
+ * Converts hundredths of a degree into a trigonometry angle.
+ *
+ * @param int32_t degrees_x100: The angle in hundredths of a degree.
+ * @return int32_t: The angle, where TRIG_MAX_ANGLE is a full circle.
+ */
+static int32_t degrees_x100_to_angle(int32_t degrees_x100) {
+	return degrees_x100 * (TRIG_MAX_ANGLE / 4) / 9000;
+}
+
+/**
+ * Integer square root.
+ *
+ * @param uint32_t value: The value.
+ * @return uint32_t: The largest integer whose square is at most value.
+ */
+static uint32_t isqrt(uint32_t value) {
+	uint32_t result = 0;
+	uint32_t bit = 1u << 30;
+
+	while (bit > value) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (value >= result + bit) {
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return result;
+}
+
+/**
+ * Returns the number of days from 1970-01-01 to the start of the given year.
+ *
+ * @param int year: Years since 1900, as in struct tm.
+ * @return int: Days since the epoch.
+ */
+static int days_to_year(int year) {
+	int y = year + 1900 - 1;
+	return 365 * (y - 1969) + (y / 4 - 1969 / 4) - (y / 100 - 1969 / 100) + (y / 400 - 1969 / 400);
+}
+
+/**
+ * Calculates sunrise and sunset for a day using the NOAA approximations, 
+ * in fixed point with the Pebble trigonometry lookups.
+ *
+ * @param struct tm *tick_time: The local date.
+ * @param daylight_t *result: Holds the times, in minutes after local midnight, 
+ *	or just the type on days when the sun does not rise or does not set.
+ */
+static void calculate_daylight(struct tm *tick_time, daylight_t *result) {
+	result->year = tick_time->tm_year;
+	result->yday = tick_time->tm_yday;
+
+	/* The formulas count the days of the year from 1. */
+	int day = tick_time->tm_yday + 1;
+
+	/* Equation of time, in hundredths of a minute. */
+	int32_t b = (day - 81) * TRIG_MAX_ANGLE / 364;
+	int32_t equation_of_time_x100 = (987 * sin_lookup(2 * b) - 753 * cos_lookup(b) - 150 * sin_lookup(b)) 
+		/ TRIG_MAX_RATIO;
+
+	/* Declination of the sun. */
+	int32_t declination_x100 = 2344 * sin_lookup((284 + day) * TRIG_MAX_ANGLE / 365) / TRIG_MAX_RATIO;
+	int32_t declination = degrees_x100_to_angle(declination_x100);
+	int32_t latitude = degrees_x100_to_angle(location.latitude_x100);
+
+	/* Hour angle of sunrise: cos(w) = (sin(h) - sin(lat) sin(dec)) / (cos(lat) cos(dec)). */
+	int64_t numerator = (int64_t) SIN_SUNRISE_ALTITUDE * TRIG_MAX_RATIO 
+		- (int64_t) sin_lookup(latitude) * sin_lookup(declination);
+	int64_t denominator = (int64_t) cos_lookup(latitude) * cos_lookup(declination) / TRIG_MAX_RATIO;
+
+	if (denominator == 0 || numerator >= denominator * TRIG_MAX_RATIO) {
+		result->type = DAYLIGHT_POLAR_NIGHT;
+		result->sunrise_minutes = 0;
+		result->sunset_minutes = 0;
+		return;
+	}
+	if (numerator <= -denominator * TRIG_MAX_RATIO) {
+		result->type = DAYLIGHT_POLAR_DAY;
+		result->sunrise_minutes = 0;
+		result->sunset_minutes = 0;
+		return;
+	}
+
+	int32_t cos_hour_angle = numerator / denominator;
+	uint32_t cos_squared = (uint32_t) cos_hour_angle * (uint32_t) cos_hour_angle;
+	int32_t sin_hour_angle = isqrt((uint32_t) TRIG_MAX_RATIO * TRIG_MAX_RATIO - cos_squared);
+	int32_t hour_angle = atan2_lookup(sin_hour_angle / 2, cos_hour_angle / 2);
+
+	/* The sun moves one degree every 4 minutes. */
+	int hour_angle_minutes = hour_angle * DAYLIGHT_MINUTES_PER_DAY / TRIG_MAX_ANGLE;
+	int solar_noon_utc_minutes = 720 - location.longitude_x100 * 4 / 100 - equation_of_time_x100 / 100;
+
+	/* Convert from minutes after midnight UTC to minutes after local midnight. */
+	time_t utc_midnight = (time_t) (days_to_year(tick_time->tm_year) + tick_time->tm_yday) * SECONDS_PER_DAY;
+	int local_offset_minutes = (utc_midnight - time_start_of_today()) / SECONDS_PER_MINUTE;
+
+	result->type = DAYLIGHT_SUNRISE_AND_SUNSET;
+	result->sunrise_minutes = solar_noon_utc_minutes - hour_angle_minutes + local_offset_minutes;
+	result->sunset_minutes = solar_noon_utc_minutes + hour_angle_minutes + local_offset_minutes;
+}
+
+/*** External Functions ***/
+
+/**
+ * Reads the cached location and the last calculated times from persistent storage.
+ */
+void daylight_load() {
+	location_known = persist_exists(STORAGE_KEY_LOCATION);
+	if (location_known) {
+		persist_read_data(STORAGE_KEY_LOCATION, &location, sizeof(location_t));
+	}
+
+	/* Times saved in another layout are recalculated. */
+	if (!persist_exists(STORAGE_KEY_DAYLIGHT) ||
+		persist_read_data(STORAGE_KEY_DAYLIGHT, &cached_daylight, sizeof(daylight_t)) 
+			!= (int) sizeof(daylight_t)) {
+		cached_daylight.yday = -1;
+	}
+}
+
+/**
+ * Returns whether a location has ever been received from the phone.
+ *
+ * @return bool: True if the times can be calculated.
+ */
+bool daylight_has_location() {
+	return location_known;
+}
+
+/**
+ * Caches the location of the phone's last weather fix.
+ *
+ * @param int32_t latitude_x100: Latitude in hundredths of a degree.
+ * @param int32_t longitude_x100: Longitude in hundredths of a degree.
+ * @return bool: True if the location moved enough that the times need recalculating.
+ */
+bool daylight_set_location(int32_t latitude_x100, int32_t longitude_x100) {
+	if (location_known && 
+		abs(latitude_x100 - location.latitude_x100) < LOCATION_THRESHOLD_X100 &&
+		abs(longitude_x100 - location.longitude_x100) < LOCATION_THRESHOLD_X100) {
+		return false;
+	}
+
+	location.latitude_x100 = latitude_x100;
+	location.longitude_x100 = longitude_x100;
+	location_known = true;
+	persist_write_data(STORAGE_KEY_LOCATION, &location, sizeof(location_t));
+
+	/* The cached times are for the old location, so the next update has to 
+	recalculate them even if it is for the same day. */
+	cached_daylight.yday = -1;
+	persist_delete(STORAGE_KEY_DAYLIGHT);
+
+	return true;
+}
+
+/**
+ * Returns the sunrise and sunset times for the given day, calculating and 
+ * saving them only if they are not already known for that day.
+ *
+ * @param struct tm *tick_time: The local date.
+ * @param bool force: Recalculate even if the times are known, e.g. after moving.
+ * @return const daylight_t*: The times, or NULL if the location is not known.
+ */
+const daylight_t* daylight_update(struct tm *tick_time, bool force) {
+	if (!location_known) {
+		return NULL;
+	}
+
+	if (force || cached_daylight.year != tick_time->tm_year || cached_daylight.yday != tick_time->tm_yday) {
+		calculate_daylight(tick_time, &cached_daylight);
+		persist_write_data(STORAGE_KEY_DAYLIGHT, &cached_daylight, sizeof(daylight_t));
+	}
+
+	return &cached_daylight;
+}
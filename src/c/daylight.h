@@ -0,0 +1,30 @@
+#pragma once
+
+#include <pebble.h>
+
+/**
+ * Whether the sun rises and sets on a day, or stays below or above the horizon.
+ */
+typedef enum {
+	DAYLIGHT_SUNRISE_AND_SUNSET,
+	DAYLIGHT_POLAR_NIGHT,
+	DAYLIGHT_POLAR_DAY
+} daylight_type_e;
+
+/**
+ * Sunrise and sunset for one day, in minutes after local midnight. The times 
+ * are only set if the type is DAYLIGHT_SUNRISE_AND_SUNSET.
+ */
+typedef struct {
+	int year;
+	int yday;
+	daylight_type_e type;
+	int sunrise_minutes;
+	int sunset_minutes;
+} daylight_t;
+
+/*** Functions ***/
+void daylight_load();
+bool daylight_has_location();
+bool daylight_set_location(int32_t latitude_x100, int32_t longitude_x100);
+const daylight_t* daylight_update(struct tm *tick_time, bool force);
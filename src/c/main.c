@@ -29,7 +29,9 @@ static void main_window_unload(Window *a_window_main) {
 
 /**
  * AppMessageInboxReceived callback for when an incoming message is received.
- * Reads either settings or temperature from the app message.
+ * Walks the message once, decoding settings as they are found and noting the 
+ * other tuples, then passes on the settings, temperature, location, remote 
+ * metrics or phone ready notice it contained.
  *
  * @param DictionaryIterator *it: The dictionary iterator to the received message.
  * @param void *context: Pointer to application data set by app_message_set_context.
@@ -38,20 +40,61 @@ static void inbox_received_callback(DictionaryIterator *it, void *context)
 {		
 	APP_LOG(APP_LOG_LEVEL_INFO, "Inbox received.");
 
-	/* Read the settings if available. */
-	Tuple *settings_mesage_tuple = dict_find(it, MESSAGE_KEY_SettingsMessage);
-	if (settings_mesage_tuple) {
-		if(settings_mesage_tuple->value->int16 > 0) {
-			bars_handle_settings_received(it, window_main);
-		}
+	settings_reader_t settings_reader;
+	settings_reader_init(&settings_reader, bars_get_settings());
+
+	const Tuple *settings_message_tuple = NULL;
+	const Tuple *temperature_tuple = NULL;
+	const Tuple *latitude_tuple = NULL;
+	const Tuple *longitude_tuple = NULL;
+	const Tuple *remote_metrics_tuple = NULL;
+	const Tuple *phone_ready_tuple = NULL;
+
+	for (Tuple *tuple = dict_read_first(it); tuple; tuple = dict_read_next(it)) {
+		if (settings_reader_read(&settings_reader, tuple))
+			continue;
+
+		if (tuple->key == MESSAGE_KEY_SettingsMessage)
+			settings_message_tuple = tuple;
+		else if (tuple->key == MESSAGE_KEY_Temperature)
+			temperature_tuple = tuple;
+		else if (tuple->key == MESSAGE_KEY_Latitude)
+			latitude_tuple = tuple;
+		else if (tuple->key == MESSAGE_KEY_Longitude)
+			longitude_tuple = tuple;
+		else if (tuple->key == MESSAGE_KEY_RemoteMetrics)
+			remote_metrics_tuple = tuple;
+		else if (tuple->key == MESSAGE_KEY_PhoneReady)
+			phone_ready_tuple = tuple;
+	}
+
+	/* Apply the settings if the message was sent by the config page. */
+	if (settings_message_tuple && settings_message_tuple->value->int16 > 0) {
+		settings_reader_finish(&settings_reader);
+		bars_handle_settings_received(&settings_reader.settings, window_main);
 	}
 
 	/* Read the temperature if available. */
-	Tuple *temperature_tuple = dict_find(it, MESSAGE_KEY_Temperature);
 	if(temperature_tuple) {
 		int current_temperature = temperature_tuple->value->int32;
 		bars_handle_temperature_received(current_temperature);
 	}
+
+	/* Read the location of the weather if available. */
+	if(latitude_tuple && longitude_tuple) {
+		bars_handle_location_received(latitude_tuple->value->int32, longitude_tuple->value->int32);
+	}
+
+	/* Read the metrics pushed by the phone if available. */
+	if(remote_metrics_tuple) {
+		bars_handle_remote_metrics_received(remote_metrics_tuple->value->data, 
+											remote_metrics_tuple->length);
+	}
+
+	/* Catch up on anything that had to wait for the phone. */
+	if(phone_ready_tuple) {
+		bars_handle_phone_ready();
+	}
 }
 
 /**
@@ -67,18 +110,19 @@ static void inbox_dropped_callback(AppMessageResult reason, void *context) {
 
 /**
  * AppMessageOutboxSent callback after an outbound message has been sent.
- * Logs the success.
+ * Logs the success and moves on to the next queued message.
  *
  * @param DictionaryIterator *it: The dictionary iterator to the sent message.
  * @param void *context: Pointer to application data set by app_message_set_context.
  */
 static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
 	APP_LOG(APP_LOG_LEVEL_INFO, "Outbox send success.");
+	outbox_handle_sent();
 }
 
 /**
  * AppMessageOutboxFailed callback after an outbound message has not been sent successfully.
- * Logs the reason.
+ * Logs the reason and schedules the message to be retried.
  *
  * @param DictionaryIterator *it: The dictionary iterator to the sent message.
  * @param AppMessageResult reason: The reason why the message was dropped.
@@ -86,6 +130,7 @@ static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
  */
 static void outbox_failed_callback(DictionaryIterator *iterator, AppMessageResult reason, void *context) {
 	APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed: %d.", reason);
+	outbox_handle_failed(reason);
 }
 
 /**
@@ -0,0 +1,191 @@
+#include <pebble.h>
+#include "outbox.h"
+
+/*** Constants ***/
+const int RETRY_BASE_DELAY_MS = 2000;
+const int MAX_ATTEMPTS = 5;
+
+/*** Types ***/
+
+/**
+ * Counters for the outbound messages, kept for logging.
+ */
+typedef struct {
+	uint16_t sent;
+	uint16_t failed;
+	uint16_t retried;
+	uint16_t deduplicated;
+	uint16_t dropped;
+} outbox_stats_t;
+
+/*** Internal Global Variables ***/
+
+/* Bit for each message type that is waiting to be sent. */
+static uint32_t pending_types;
+
+/* The message type currently being sent, or -1 if none. */
+static int in_flight = -1;
+
+/* Number of failed attempts to send the message at the front of the queue. */
+static int attempts;
+
+static AppTimer *retry_timer;
+static outbox_stats_t stats;
+
+/*** Internal Functions ***/
+
+static void send_next();
+
+/**
+ * Writes the contents of a message into the outbox dictionary.
+ *
+ * @param DictionaryIterator *iter: The outbox dictionary.
+ * @param outbox_message_e type: The type of message to write.
+ */
+static void write_message(DictionaryIterator *iter, outbox_message_e type) {
+	switch (type) {
+		case OUTBOX_MESSAGE_FETCH_TEMPERATURE:
+			/* Set the FetchTemperature message key to indicate that 
+			the phone should retrieve the temperature. */
+			dict_write_uint8(iter, MESSAGE_KEY_FetchTemperature, 1);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Returns the message type that should be sent next.
+ *
+ * @return int: The message type, or -1 if nothing is pending.
+ */
+static int next_pending_type() {
+	for (int type = 0; type < OUTBOX_MESSAGE_TYPES; ++type) {
+		if (pending_types & (1 << type)) {
+			return type;
+		}
+	}
+	return -1;
+}
+
+/**
+ * AppTimerCallback for retrying after a failed or refused send.
+ *
+ * @param void *context: Unused.
+ */
+static void retry_timer_callback(void *context) {
+	retry_timer = NULL;
+	++stats.retried;
+	send_next();
+}
+
+/**
+ * Schedules another attempt at sending the next message, waiting twice as long 
+ * after each failure. After too many failures the message is dropped, since 
+ * every message type is sent again periodically anyway.
+ */
+static void schedule_retry() {
+	++attempts;
+
+	if (attempts >= MAX_ATTEMPTS) {
+		int type = next_pending_type();
+		APP_LOG(APP_LOG_LEVEL_ERROR, "Giving up on outbox message %d after %d attempts.", type, attempts);
+		pending_types &= ~(1 << type);
+		attempts = 0;
+		++stats.dropped;
+		send_next();
+		return;
+	}
+
+	retry_timer = app_timer_register(RETRY_BASE_DELAY_MS << (attempts - 1), retry_timer_callback, NULL);
+}
+
+/**
+ * Sends the next pending message, unless a message is already being sent 
+ * or waiting to be retried.
+ */
+static void send_next() {
+	if (in_flight >= 0 || retry_timer) {
+		return;
+	}
+
+	int type = next_pending_type();
+	if (type < 0) {
+		return;
+	}
+
+	/* The outbox is busy if a message is still going out or one is coming in. */
+	DictionaryIterator *iter;
+	AppMessageResult result = app_message_outbox_begin(&iter);
+	if (result == APP_MSG_OK) {
+		write_message(iter, type);
+		result = app_message_outbox_send();
+	}
+
+	if (result == APP_MSG_OK) {
+		in_flight = type;
+	}
+	else {
+		APP_LOG(APP_LOG_LEVEL_WARNING, "Outbox unavailable: %d.", result);
+		schedule_retry();
+	}
+}
+
+/*** External Functions ***/
+
+/**
+ * Queues a message to be sent to the phone. If a message of the same type 
+ * is already waiting, the two are merged into one.
+ *
+ * @param outbox_message_e type: The type of message to send.
+ */
+void outbox_enqueue(outbox_message_e type) {
+	if (pending_types & (1 << type)) {
+		++stats.deduplicated;
+		return;
+	}
+
+	pending_types |= (1 << type);
+	send_next();
+}
+
+/**
+ * Called from the AppMessageOutboxSent callback. 
+ * Removes the sent message from the queue and sends the next one.
+ */
+void outbox_handle_sent() {
+	if (in_flight >= 0) {
+		pending_types &= ~(1 << in_flight);
+	}
+	in_flight = -1;
+	attempts = 0;
+	++stats.sent;
+
+	send_next();
+}
+
+/**
+ * Called from the AppMessageOutboxFailed callback. 
+ * Schedules the failed message to be retried.
+ *
+ * @param AppMessageResult reason: The reason why the message was not sent.
+ */
+void outbox_handle_failed(AppMessageResult reason) {
+	in_flight = -1;
+	++stats.failed;
+
+	APP_LOG(APP_LOG_LEVEL_INFO, "Outbox stats: %d sent, %d failed, %d retried, %d deduplicated, %d dropped.",
+			stats.sent, stats.failed, stats.retried, stats.deduplicated, stats.dropped);
+
+	schedule_retry();
+}
+
+/**
+ * Cancels any pending retry.
+ */
+void outbox_deinit() {
+	if (retry_timer) {
+		app_timer_cancel(retry_timer);
+		retry_timer = NULL;
+	}
+}
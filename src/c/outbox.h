@@ -0,0 +1,18 @@
+#pragma once
+
+#include <pebble.h>
+
+/**
+ * Types of messages the watch sends to the phone.
+ * At most one of each type is ever waiting to be sent.
+ */
+typedef enum {
+	OUTBOX_MESSAGE_FETCH_TEMPERATURE,
+	OUTBOX_MESSAGE_TYPES
+} outbox_message_e;
+
+/*** Functions ***/
+void outbox_enqueue(outbox_message_e type);
+void outbox_handle_sent();
+void outbox_handle_failed(AppMessageResult reason);
+void outbox_deinit();
@@ -0,0 +1,187 @@
+#include <pebble.h>
+#include <string.h>
+#include "configuration.h"
+#include "remote_metrics.h"
+
+/*** Constants ***/
+
+/* Size of the fixed part of each record in a frame: id, color, progress (2 bytes)
+and label length. The label bytes follow. */
+const int RECORD_HEADER_SIZE = 5;
+
+/* Version of the table layout in persistent storage. Tables saved with any 
+other version are dropped. */
+const uint8_t REMOTE_METRICS_VERSION = 1;
+
+/*** Types ***/
+
+/**
+ * The metrics as kept in persistent storage.
+ */
+typedef struct {
+	uint8_t version;
+	int count;
+	remote_metric_t metrics[MAX_REMOTE_METRICS];
+} remote_metrics_table_t;
+
+/*** Internal Global Variables ***/
+static remote_metrics_table_t table;
+
+/*** Internal Functions ***/
+
+/**
+ * Finds the metric with the given id.
+ *
+ * @param uint8_t id: The id assigned to the metric by the phone.
+ * @return int: Index of the metric in the table, or -1 if it is not there.
+ */
+static int find_metric(uint8_t id) {
+	for (int i = 0; i < table.count; ++i) {
+		if (table.metrics[i].id == id) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Removes the metric at the given index, keeping the others in order.
+ *
+ * @param int index: Index of the metric in the table.
+ */
+static void remove_metric(int index) {
+	memmove(&table.metrics[index], &table.metrics[index + 1], 
+			(table.count - index - 1) * sizeof(remote_metric_t));
+	--table.count;
+}
+
+/*** External Functions ***/
+
+/**
+ * Reads the metrics last received from the phone from persistent storage. A 
+ * table that was saved in another layout or holds more metrics than fit is 
+ * dropped, and no metrics are shown until the phone sends them again.
+ */
+void remote_metrics_load() {
+	if (!persist_exists(STORAGE_KEY_REMOTE_METRICS) ||
+		persist_read_data(STORAGE_KEY_REMOTE_METRICS, &table, sizeof(remote_metrics_table_t)) 
+			!= (int) sizeof(remote_metrics_table_t) ||
+		table.version != REMOTE_METRICS_VERSION ||
+		table.count < 0 || table.count > MAX_REMOTE_METRICS) {
+		table.count = 0;
+	}
+}
+
+/**
+ * Saves the metrics to persistent storage, so they can be shown as soon as the app loads.
+ */
+void remote_metrics_save() {
+	table.version = REMOTE_METRICS_VERSION;
+	persist_write_data(STORAGE_KEY_REMOTE_METRICS, &table, sizeof(remote_metrics_table_t));
+}
+
+/**
+ * Decodes a frame of metric updates sent by the phone into the metrics table. 
+ * The frame is a count byte followed by that many records, each made of the
+ * metric id, its GColor8 value, its progress in thousandths as a little-endian
+ * uint16 (or REMOTE_METRIC_REMOVE), the label length and the label bytes. Metrics
+ * that are not in the frame keep their previous values.
+ *
+ * @param const uint8_t *data: The frame, read in place from the AppMessage tuple.
+ * @param uint16_t length: Length of the frame in bytes.
+ * @return remote_metrics_result_e: Whether the frame changed any values or changed 
+ *	which metrics are shown.
+ */
+remote_metrics_result_e remote_metrics_decode(const uint8_t *data, uint16_t length) {
+	remote_metrics_result_e result = REMOTE_METRICS_UNCHANGED;
+
+	if (length < 1) {
+		return result;
+	}
+
+	int record_count = data[0];
+	int offset = 1;
+
+	for (int r = 0; r < record_count; ++r) {
+		if (offset + RECORD_HEADER_SIZE > length) {
+			APP_LOG(APP_LOG_LEVEL_ERROR, "Remote metrics frame truncated at record %d.", r);
+			break;
+		}
+
+		uint8_t id = data[offset];
+		GColor color = (GColor) { .argb = data[offset + 1] };
+		uint16_t progress_permille = data[offset + 2] | (data[offset + 3] << 8);
+		int label_length = data[offset + 4];
+		const uint8_t *label = &data[offset + RECORD_HEADER_SIZE];
+		offset += RECORD_HEADER_SIZE + label_length;
+
+		if (offset > length) {
+			APP_LOG(APP_LOG_LEVEL_ERROR, "Remote metrics frame truncated at record %d.", r);
+			break;
+		}
+
+		int index = find_metric(id);
+
+		if (progress_permille == REMOTE_METRIC_REMOVE) {
+			if (index >= 0) {
+				remove_metric(index);
+				result = REMOTE_METRICS_LAYOUT_CHANGED;
+			}
+			continue;
+		}
+
+		if (index < 0) {
+			if (table.count == MAX_REMOTE_METRICS) {
+				APP_LOG(APP_LOG_LEVEL_ERROR, "No room for remote metric %d.", id);
+				continue;
+			}
+			index = table.count++;
+			memset(&table.metrics[index], 0, sizeof(remote_metric_t));
+			table.metrics[index].id = id;
+			result = REMOTE_METRICS_LAYOUT_CHANGED;
+		}
+
+		remote_metric_t *metric = &table.metrics[index];
+
+		/* Ignore updates that do not change what is shown. */
+		if (label_length >= REMOTE_METRIC_LABEL_WIDTH) {
+			label_length = REMOTE_METRIC_LABEL_WIDTH - 1;
+		}
+		if (gcolor_equal(metric->color, color) && 
+			metric->progress_permille == progress_permille && 
+			strncmp(metric->label, (const char *) label, label_length) == 0 && 
+			metric->label[label_length] == '\0') {
+			continue;
+		}
+
+		metric->color = color;
+		metric->progress_permille = progress_permille;
+		memcpy(metric->label, label, label_length);
+		metric->label[label_length] = '\0';
+
+		if (result == REMOTE_METRICS_UNCHANGED) {
+			result = REMOTE_METRICS_VALUES_CHANGED;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * Returns the number of metrics currently supplied by the phone.
+ *
+ * @return int: The count of remote metrics.
+ */
+int remote_metrics_count() {
+	return table.count;
+}
+
+/**
+ * Returns one of the metrics supplied by the phone.
+ *
+ * @param int index: Index in the range [0, remote_metrics_count()).
+ * @return const remote_metric_t*: The metric.
+ */
+const remote_metric_t* remote_metrics_get(int index) {
+	return &table.metrics[index];
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <pebble.h>
+
+/**
+ * Most metric bars the phone can push at once.
+ */
+#define MAX_REMOTE_METRICS 3
+
+/**
+ * Size of a remote metric's label, including the terminator.
+ */
+#define REMOTE_METRIC_LABEL_WIDTH 8
+
+/**
+ * Progress value that removes a metric instead of updating it.
+ */
+#define REMOTE_METRIC_REMOVE 0xFFFF
+
+/**
+ * Results of decoding a remote metrics frame.
+ */
+typedef enum {
+	REMOTE_METRICS_UNCHANGED,
+	REMOTE_METRICS_VALUES_CHANGED,
+	REMOTE_METRICS_LAYOUT_CHANGED
+} remote_metrics_result_e;
+
+/**
+ * A bar whose value, color and label are supplied by the phone.
+ */
+typedef struct {
+	uint8_t id;
+	GColor color;
+	uint16_t progress_permille;
+	char label[REMOTE_METRIC_LABEL_WIDTH];
+} remote_metric_t;
+
+/*** Functions ***/
+void remote_metrics_load();
+void remote_metrics_save();
+remote_metrics_result_e remote_metrics_decode(const uint8_t *data, uint16_t length);
+int remote_metrics_count();
+const remote_metric_t* remote_metrics_get(int index);
@@ -0,0 +1,198 @@
+#include <pebble.h>
+#include "renderers.h"
+#include "utilities.h"
+
+/*** Constants ***/
+#define CORNER_RADIUS 4
+
+#if !defined(PBL_COLOR)
+/* Insets of the rounded right end of a bar for each row from the top or bottom,
+matching CORNER_RADIUS. */
+static const uint8_t CORNER_INSETS[CORNER_RADIUS] = {2, 1, 0, 0};
+
+/* 8x8 dither patterns for 0%, 25%, 50%, 75% and 100% white, one byte per row,
+with 0, 2, 4, 6 or 8 bits of every row set. The least significant bit is the 
+leftmost pixel, as in the frame buffer. */
+static const uint8_t DITHER_PATTERNS[5][8] = {
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x11, 0x44, 0x11, 0x44, 0x11, 0x44, 0x11, 0x44},
+	{0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA},
+	{0xEE, 0xBB, 0xEE, 0xBB, 0xEE, 0xBB, 0xEE, 0xBB},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}
+};
+#endif
+
+/*** Internal Functions ***/
+
+/*
+ * The building blocks below make up one routine per bar style, so that 
+ * drawing a bar never has to check the settings. Anything that depends on the 
+ * platform is chosen at compile time.
+ */
+
+#if defined(PBL_COLOR)
+/**
+ * Fills the bar as a rectangle with rounded corners on the right.
+ */
+static inline void fill_solid(GContext *ctx, GRect bar_rect, GColor bar_color) {
+	graphics_context_set_fill_color(ctx, bar_color);
+	graphics_fill_rect(ctx, bar_rect, CORNER_RADIUS, GCornersRight);
+}
+#else
+/**
+ * Picks the dither pattern for a color by its brightness.
+ *
+ * @param GColor color: The color chosen for the bar.
+ * @return int: Index into DITHER_PATTERNS.
+ */
+static inline int get_dither_level(GColor color) {
+	int r = (color.argb >> 4) & 0x3;
+	int g = (color.argb >> 2) & 0x3;
+	int b = color.argb & 0x3;
+
+	/* Weighted so that white is 4, light gray 3, dark gray 1 and black 0. */
+	return (r * 2 + g * 5 + b + 3) / 6;
+}
+
+/**
+ * Fills one row of the frame buffer from x0 up to (not including) x1 with a 
+ * pattern byte, a 32-bit word at a time.
+ *
+ * @param uint8_t *row: Start of the row in the frame buffer. Must be word aligned.
+ * @param int x0: First pixel to fill.
+ * @param int x1: Pixel after the last one to fill.
+ * @param uint8_t pattern: Pattern for the row, repeating every 8 pixels.
+ */
+static inline void fill_row(uint8_t *row, int x0, int x1, uint8_t pattern) {
+	uint32_t *words = (uint32_t *) row;
+	uint32_t pattern_word = pattern * 0x01010101u;
+
+	int first_word = x0 / 32;
+	int last_word = (x1 - 1) / 32;
+	uint32_t first_mask = ~0u << (x0 % 32);
+	uint32_t last_mask = ~0u >> (31 - (x1 - 1) % 32);
+
+	if (first_word == last_word) {
+		uint32_t mask = first_mask & last_mask;
+		words[first_word] = (words[first_word] & ~mask) | (pattern_word & mask);
+		return;
+	}
+
+	words[first_word] = (words[first_word] & ~first_mask) | (pattern_word & first_mask);
+	for (int w = first_word + 1; w < last_word; ++w) {
+		words[w] = pattern_word;
+	}
+	words[last_word] = (words[last_word] & ~last_mask) | (pattern_word & last_mask);
+}
+
+/**
+ * Fills the bar with the dither pattern for its color, with rounded corners on 
+ * the right. Writes straight to the frame buffer, so that bars in different 
+ * colors can be told apart on a black and white screen.
+ */
+static inline void fill_solid(GContext *ctx, GRect bar_rect, GColor bar_color) {
+	GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+	if (!frame_buffer) {
+		graphics_context_set_fill_color(ctx, bar_color);
+		graphics_fill_rect(ctx, bar_rect, CORNER_RADIUS, GCornersRight);
+		return;
+	}
+
+	GRect screen = gbitmap_get_bounds(frame_buffer);
+	uint8_t *data = gbitmap_get_data(frame_buffer);
+	int bytes_per_row = gbitmap_get_bytes_per_row(frame_buffer);
+	const uint8_t *pattern = DITHER_PATTERNS[get_dither_level(bar_color)];
+
+	int top = bar_rect.origin.y;
+	int bottom = bar_rect.origin.y + bar_rect.size.h;
+	int right = MIN(bar_rect.size.w, screen.size.w);
+
+	for (int y = MAX(top, 0); y < MIN(bottom, screen.size.h); ++y) {
+		/* Round off the right end near the top and bottom rows. */
+		int corner_row = MIN(y - top, bottom - 1 - y);
+		int x1 = right;
+		if (corner_row < CORNER_RADIUS && right == bar_rect.size.w) {
+			x1 -= CORNER_INSETS[corner_row];
+		}
+
+		if (x1 > 0) {
+			fill_row(data + y * bytes_per_row, 0, x1, pattern[y % 8]);
+		}
+	}
+
+	graphics_release_frame_buffer(ctx, frame_buffer);
+}
+#endif
+
+/**
+ * Draws the outline of the bar, two pixels wide.
+ */
+static inline void fill_outline(GContext *ctx, GRect bar_rect, GColor bar_color) {
+	graphics_context_set_stroke_color(ctx, bar_color);
+	/* Since graphics_draw_round_rect only draw 1 pixel wide, draw two rectangles slightly offset.
+	Also, graphics_draw_round_rect does not allow a corner mask, so start it offscreen to avoid 
+	having rounded corners on the left side. */
+	graphics_draw_round_rect(ctx, GRect(-2, bar_rect.origin.y, bar_rect.size.w + 2, bar_rect.size.h), CORNER_RADIUS);	
+	graphics_draw_round_rect(ctx, GRect(-2, bar_rect.origin.y + 1, bar_rect.size.w + 3, bar_rect.size.h), CORNER_RADIUS);	
+}
+
+/**
+ * Draws a bar filled with its color, and its label.
+ */
+static void draw_solid_bar(GContext *ctx, GRect bar_rect, GColor bar_color, const char *label, 
+						   GFont font, GRect label_rect, GColor text_color, GColor outline_color) {
+	fill_solid(ctx, bar_rect, bar_color);
+	renderers_draw_label(ctx, label, font, label_rect, text_color, outline_color);
+}
+
+/**
+ * Draws the outline of a bar in its color, and its label.
+ */
+static void draw_outline_bar(GContext *ctx, GRect bar_rect, GColor bar_color, const char *label, 
+							 GFont font, GRect label_rect, GColor text_color, GColor outline_color) {
+	fill_outline(ctx, bar_rect, bar_color);
+	renderers_draw_label(ctx, label, font, label_rect, text_color, outline_color);
+}
+
+/*** External Functions ***/
+
+/**
+ * Picks the draw routine for a bar style. Should be called whenever the bar 
+ * style changes.
+ *
+ * @param bar_style_e bar_style: The style to draw the bars in.
+ * @return draw_bar_fn: The routine to draw each bar with.
+ */
+draw_bar_fn renderers_select(bar_style_e bar_style) {
+	return bar_style == SOLID ? draw_solid_bar : draw_outline_bar;
+}
+
+/**
+ * Draws a label in the text color with an outline around it. Also used on its 
+ * own by bars that draw their own body.
+ *
+ * @param GContext *ctx: Graphics context to draw in.
+ * @param const char *label: The text to be drawn.
+ * @param GFont font: The font for the label.
+ * @param GRect label_rect: Where to draw the label.
+ * @param GColor text_color: Color of the label.
+ * @param GColor outline_color: Color of the outline around the label.
+ */
+void renderers_draw_label(GContext *ctx, const char *label, GFont font, GRect label_rect, 
+						  GColor text_color, GColor outline_color) {
+	draw_outlined_text(ctx, label, font, label_rect.origin.x, label_rect.origin.y, 
+					   label_rect.size, text_color, outline_color);
+}
+
+#if !defined(PBL_COLOR)
+/**
+ * Returns the dither pattern solid bars are filled with for a color, for bars 
+ * that draw their own body. Row y of the screen uses byte y % 8.
+ *
+ * @param GColor color: The color chosen for the bar.
+ * @return const uint8_t *: The 8 rows of the pattern.
+ */
+const uint8_t *renderers_get_dither_pattern(GColor color) {
+	return DITHER_PATTERNS[get_dither_level(color)];
+}
+#endif
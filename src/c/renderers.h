@@ -0,0 +1,28 @@
+#pragma once
+
+#include <pebble.h>
+#include "configuration.h"
+
+/**
+ * Draws a bar and its label.
+ *
+ * @param GContext *ctx: Graphics context to draw in.
+ * @param GRect bar_rect: The filled part of the bar.
+ * @param GColor bar_color: Color used to draw the bar.
+ * @param const char *label: The text to be drawn at the end of the bar.
+ * @param GFont font: The font for the label.
+ * @param GRect label_rect: Where to draw the label.
+ * @param GColor text_color: Color of the label.
+ * @param GColor outline_color: Color of the outline around the label.
+ */
+typedef void (*draw_bar_fn)(GContext *ctx, GRect bar_rect, GColor bar_color, 
+							const char *label, GFont font, GRect label_rect, 
+							GColor text_color, GColor outline_color);
+
+/*** Functions ***/
+draw_bar_fn renderers_select(bar_style_e bar_style);
+void renderers_draw_label(GContext *ctx, const char *label, GFont font, GRect label_rect, 
+						  GColor text_color, GColor outline_color);
+#if !defined(PBL_COLOR)
+const uint8_t *renderers_get_dither_pattern(GColor color);
+#endif
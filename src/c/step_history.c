@@ -0,0 +1,164 @@
+#include <pebble.h>
+#include <string.h>
+#include "step_history.h"
+#include "worker_state.h"
+
+/*** Internal Global Variables ***/
+
+/* Steps taken in each hour of today. Used as a ring buffer indexed by the 
+hour of the day, so slots are cleared as each new hour starts. */
+static uint16_t steps_per_hour[STEP_HISTORY_HOURS];
+
+/* The day's step total and the time at the last update, used to turn each
+new total into a delta for the current hour. */
+static int last_steps_today;
+static time_t last_update_time;
+static int last_hour;
+static bool valid;
+
+/*** Internal Functions ***/
+
+/**
+ * Rebuilds the history from the minute-level health data.
+ * This is only done at startup or after a gap in the updates, since it 
+ * reads back through every minute of the day.
+ *
+ * @param time_t now: The current time.
+ * @param int hour: The current hour of the day.
+ * @param int steps_today: The day's step total.
+ */
+static void rebuild(time_t now, int hour, int steps_today) {
+	memset(steps_per_hour, 0, sizeof(steps_per_hour));
+
+	HealthMinuteData *minutes = malloc(MINUTES_PER_HOUR * sizeof(HealthMinuteData));
+	if (!minutes) {
+		return;
+	}
+
+	time_t start_of_today = time_start_of_today();
+	int history_total = 0;
+
+	for (int h = 0; h <= hour; ++h) {
+		time_t start = start_of_today + h * SECONDS_PER_HOUR;
+		time_t end = MIN(start + SECONDS_PER_HOUR, now);
+		uint32_t count = health_service_get_minute_history(minutes, MINUTES_PER_HOUR, &start, &end);
+
+		int sum = 0;
+		for (uint32_t m = 0; m < count; ++m) {
+			if (!minutes[m].is_invalid) {
+				sum += minutes[m].steps;
+			}
+		}
+		steps_per_hour[h] = sum;
+		history_total += sum;
+	}
+
+	free(minutes);
+
+	/* The minute history lags behind the running total, so the difference 
+	belongs to the current hour. */
+	if (steps_today > history_total) {
+		steps_per_hour[hour] += steps_today - history_total;
+	}
+}
+
+/**
+ * Takes the history from the background worker's record instead of rebuilding 
+ * it, if the worker has kept it up to date. The hours before the current one 
+ * come from the record and the rest of the day's steps go in the current hour.
+ *
+ * @param int hour: The current hour of the day.
+ * @param int steps_today: The day's step total.
+ * @return bool: True if the history was taken from the worker.
+ */
+static bool restore_from_worker(int hour, int steps_today) {
+	if (!persist_exists(WORKER_STATE_STORAGE_KEY)) {
+		return false;
+	}
+
+	worker_state_t state;
+	persist_read_data(WORKER_STATE_STORAGE_KEY, &state, sizeof(worker_state_t));
+
+	/* The record is only complete up to the hour in which it was saved. */
+	if (state.version != WORKER_STATE_VERSION || state.start_of_day != time_start_of_today() ||
+		state.hour != hour) {
+		return false;
+	}
+
+	memset(steps_per_hour, 0, sizeof(steps_per_hour));
+
+	int earlier_hours_total = 0;
+	for (int h = 0; h < hour; ++h) {
+		steps_per_hour[h] = state.steps_per_hour[h];
+		earlier_hours_total += state.steps_per_hour[h];
+	}
+	steps_per_hour[hour] = MAX(steps_today - earlier_hours_total, 0);
+
+	return true;
+}
+
+/*** External Functions ***/
+
+/**
+ * Forgets the history, so that the next update rebuilds it.
+ */
+void step_history_reset() {
+	valid = false;
+}
+
+/**
+ * Updates the history with the day's latest step total. Normally this only adds
+ * the steps since the last update to the current hour; the full history is only 
+ * re-read after a reset, a gap of more than an hour, or a new day, and then only
+ * if the background worker has not kept it.
+ *
+ * @param int steps_today: The day's step total.
+ * @return bool: True if the history changed.
+ */
+bool step_history_update(int steps_today) {
+	time_t now = time(NULL);
+	int hour = localtime(&now)->tm_hour;
+
+	if (!valid || steps_today < last_steps_today || hour < last_hour || 
+		now - last_update_time > SECONDS_PER_HOUR) {
+		if (!restore_from_worker(hour, steps_today)) {
+			rebuild(now, hour, steps_today);
+		}
+		valid = true;
+	}
+	else {
+		if (steps_today == last_steps_today && hour == last_hour) {
+			return false;
+		}
+
+		/* Clear the slots for any hours that have started since the last update. */
+		for (int h = last_hour + 1; h <= hour; ++h) {
+			steps_per_hour[h] = 0;
+		}
+		steps_per_hour[hour] += steps_today - last_steps_today;
+	}
+
+	last_steps_today = steps_today;
+	last_update_time = now;
+	last_hour = hour;
+
+	return true;
+}
+
+/**
+ * Returns the steps taken in each hour of today.
+ *
+ * @return const uint16_t*: Array of STEP_HISTORY_HOURS step counts, indexed by hour.
+ */
+const uint16_t* step_history_get() {
+	return steps_per_hour;
+}
+
+/**
+ * Returns the hour of the day of the last update.
+ *
+ * @return int: The hour, in the range [0-23].
+ */
+int step_history_current_hour() {
+	return last_hour;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <pebble.h>
+
+#define STEP_HISTORY_HOURS 24
+
+/*** Functions ***/
+void step_history_reset();
+bool step_history_update(int steps_today);
+const uint16_t* step_history_get();
+int step_history_current_hour();
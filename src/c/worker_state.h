@@ -0,0 +1,25 @@
+#pragma once
+
+/* Shared by the watchface and its background worker, so this only relies 
+on what both pebble.h and pebble_worker.h provide. */
+#include <stdint.h>
+#include <time.h>
+
+#define WORKER_STATE_HOURS 24
+#define WORKER_STATE_VERSION 1
+
+/* Persistent storage is shared by the watchface and the worker. The worker's 
+record is kept well clear of the watchface's own keys in configuration.h. */
+#define WORKER_STATE_STORAGE_KEY 1000
+
+/**
+ * What the background worker collects while the watchface is not running.
+ * The worker saves it each time an hour ends, so the hours before the saved 
+ * hour are complete.
+ */
+typedef struct {
+	uint8_t version;
+	uint8_t hour;
+	time_t start_of_day;
+	uint16_t steps_per_hour[WORKER_STATE_HOURS];
+} worker_state_t;
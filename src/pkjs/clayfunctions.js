@@ -11,7 +11,8 @@ module.exports = function(minified) {
 	var DAY_BAR_IDX = 6;
 	var COMBINED_MONTH_DAY_BAR_IDX = 7;
 	var TEMPERATURE_BAR_IDX = 8;
-	var TOTAL_BARS = 11;
+	var STEPS_BAR_IDX = 9;
+	var TOTAL_BARS = 12;
 		
 	var barCheckboxesSaved;
 	
@@ -75,8 +76,34 @@ module.exports = function(minified) {
 		else {
 			hideTemperatureOptions();
 		}
+		
+		/* Show or hide the Steps options. */
+		if (barCheckboxesNew[STEPS_BAR_IDX]) {
+			clayConfig.getItemById('stepsSparklineToggle').show();
+		}
+		else {
+			clayConfig.getItemById('stepsSparklineToggle').hide();
+		}
+		handleStepsSparklineChanged();
 	}	
 	
+	/**
+	 * Shows the background worker option only if the steps per hour chart is shown,
+	 * since that is all the worker collects.
+	 */
+	function handleStepsSparklineChanged() {
+		var barCheckboxesGroup = clayConfig.getItemById('barCheckboxesGroup');
+		var stepsSparklineToggle = clayConfig.getItemById('stepsSparklineToggle');
+		var backgroundWorkerToggle = clayConfig.getItemById('backgroundWorkerToggle');
+		
+		if (barCheckboxesGroup.get()[STEPS_BAR_IDX] && stepsSparklineToggle.get()) {
+			backgroundWorkerToggle.show();
+		}
+		else {
+			backgroundWorkerToggle.hide();
+		}
+	}
+	
 	/**		
 	 * Keeps the two sets of temperature bounds sliders in sync.
 	 */		
@@ -157,6 +184,23 @@ module.exports = function(minified) {
 		tempScaleRadio.hide();	
 	}	
 	
+	/**
+	 * Shows the quiet hours sliders only if quiet hours are turned on.
+	 */
+	function handleQuietWindowChanged() {
+		var quietStartSlider = clayConfig.getItemById('quietStartSlider');
+		var quietEndSlider = clayConfig.getItemById('quietEndSlider');
+		
+		if (this.get()) {
+			quietStartSlider.show();
+			quietEndSlider.show();
+		}
+		else {
+			quietStartSlider.hide();
+			quietEndSlider.hide();
+		}
+	}
+	
 	/* Initialize the page and add all the event handlers.. */
 	clayConfig.on(clayConfig.EVENTS.AFTER_BUILD, function() {
 		var barCheckboxesGroup = clayConfig.getItemById('barCheckboxesGroup');
@@ -165,6 +209,7 @@ module.exports = function(minified) {
 		var tempUpperBoundSliderF = clayConfig.getItemById('tempUpperBoundSliderF');		
 		var tempLowerBoundSliderC = clayConfig.getItemById('tempLowerBoundSliderC');		
 		var tempUpperBoundSliderC = clayConfig.getItemById('tempUpperBoundSliderC');	
+		var quietWindowToggle = clayConfig.getItemById('quietWindowToggle');
 		
 		barCheckboxesSaved = barCheckboxesGroup.get();
 
@@ -176,5 +221,10 @@ module.exports = function(minified) {
 		tempUpperBoundSliderF.on('change', syncTemperatureSliders);	
 		tempLowerBoundSliderC.on('change', syncTemperatureSliders);	
 		tempUpperBoundSliderC.on('change', syncTemperatureSliders);	
+		
+		handleQuietWindowChanged.call(quietWindowToggle);
+		quietWindowToggle.on('change', handleQuietWindowChanged);
+		
+		clayConfig.getItemById('stepsSparklineToggle').on('change', handleStepsSparklineChanged);
 	});
 };
@@ -21,9 +21,10 @@ function generateLayoutWithDefaultColors(barDefaultColors) {
 					"id": "barCheckboxesGroup",
 					"messageKey": "BarCheckboxes",
 					"description": "Choose what information will be displayed. Note: Displaying seconds will reduce battery life.", 
-					"defaultValue": [false, false, true, true, true, false, false, true, true, true, true],
+					"defaultValue": [false, false, true, true, true, false, false, true, true, true, true, false],
 					"options": ["Hours", "Minutes", "Hours and Minutes Combined", "Seconds", "Day of week", 
-								"Month", "Day of month", "Month and Day Combined", "Temperature", "Steps", "Battery"]
+								"Month", "Day of month", "Month and Day Combined", "Temperature", "Steps", "Battery", 
+								"Daylight"]
 				}
 			]
 		},
@@ -143,6 +144,14 @@ function generateLayoutWithDefaultColors(barDefaultColors) {
 					"sunlight": false,
 					"label": "Battery Bar Color",
 					"allowGray": true
+				},
+				{
+					"type": "color",
+					"messageKey": "BarColors[11]",
+					"defaultValue": barDefaultColors[11],
+					"sunlight": false,
+					"label": "Daylight Bar Color",
+					"allowGray": true
 				}					
 			]
 		},
@@ -168,6 +177,55 @@ function generateLayoutWithDefaultColors(barDefaultColors) {
 							"value": "O"
 						}
 					]
+				},
+				{
+					"type": "toggle",
+					"messageKey": "StepsSparkline",
+					"id": "stepsSparklineToggle",
+					"label": "Show Steps per Hour",
+					"description": "Draws the steps bar as a chart of the steps taken in each hour of the day.",
+					"defaultValue": false
+				},
+				{
+					"type": "toggle",
+					"messageKey": "BackgroundWorker",
+					"id": "backgroundWorkerToggle",
+					"label": "Count Steps in the Background",
+					"description": "Keeps the steps per hour up to date while other apps are open, so the chart is ready straight away. Replaces any other app's background worker.",
+					"defaultValue": false
+				},
+				{
+					"type": "toggle",
+					"messageKey": "QuietModeSleep",
+					"label": "Quiet While Sleeping",
+					"description": "While you are asleep, only the time is updated, once a minute. Saves battery.",
+					"defaultValue": true
+				},
+				{
+					"type": "toggle",
+					"messageKey": "QuietModeWindow",
+					"id": "quietWindowToggle",
+					"label": "Quiet Hours",
+					"description": "Between these hours, only the time is updated, once a minute.",
+					"defaultValue": false
+				},
+				{
+					"type": "slider",
+					"messageKey": "QuietStartHour",
+					"id": "quietStartSlider",
+					"defaultValue": 23,
+					"label": "Quiet Hours Start",
+					"min": 0,
+					"max": 23
+				},
+				{
+					"type": "slider",
+					"messageKey": "QuietEndHour",
+					"id": "quietEndSlider",
+					"defaultValue": 7,
+					"label": "Quiet Hours End",
+					"min": 0,
+					"max": 23
 				},			
 				{
 					"type": "radiogroup",
@@ -244,5 +302,5 @@ function generateLayoutWithDefaultColors(barDefaultColors) {
 	];
 }
 
-module.exports.colorLayout = generateLayoutWithDefaultColors([0x000055, 0x0000AA, 0x0000AA, 0x00AAFF, 0xFFAA55, 0xAAFF00, 0xFFFF00, 0xFFFF00, 0x550055, 0x005500, 0xFF0000]);
-module.exports.blackWhiteLayout = generateLayoutWithDefaultColors([0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF]);
+module.exports.colorLayout = generateLayoutWithDefaultColors([0x000055, 0x0000AA, 0x0000AA, 0x00AAFF, 0xFFAA55, 0xAAFF00, 0xFFFF00, 0xFFFF00, 0x550055, 0x005500, 0xFF0000, 0xFFAA00]);
+module.exports.blackWhiteLayout = generateLayoutWithDefaultColors([0xFFFFFF, 0xAAAAAA, 0xFFFFFF, 0xAAAAAA, 0xFFFFFF, 0xAAAAAA, 0xFFFFFF, 0xAAAAAA, 0xFFFFFF, 0xAAAAAA, 0xFFFFFF, 0xAAAAAA]);
@@ -2,6 +2,7 @@ var Clay = require('pebble-clay');
 var clayConfig = require('./claylayout');
 var clayFunctions = require('./clayfunctions');
 var weather = require('./weather');
+var metrics = require('./metrics');
 
 /* Initialize Clay. */
 var clay = new Clay(clayConfig.colorLayout, clayFunctions, {autoHandleEvents: false});
@@ -9,7 +10,18 @@ var clay = new Clay(clayConfig.colorLayout, clayFunctions, {autoHandleEvents: fa
 /* Listen for when the watchface is opened. */
 Pebble.addEventListener('ready', function(e) {
 	console.log('PebbleKit JS ready!');
-	weather.getWeather(); 
+
+	/* Let the watch know it can send requests now. It asks for the weather 
+	then if it is due, so none is fetched here. */
+	Pebble.sendAppMessage({ 'PhoneReady': 1 }, function(e) {
+		console.log('Sent ready notice to Pebble.');
+	}, function(e) {
+		console.log('Failed to send ready notice to Pebble.');
+	});
+
+	/* Register metric providers here to add bars pushed from the phone, e.g.
+	metrics.registerProvider(0xFF5500, metrics.weekProvider()); */
+	metrics.start();
 });
 
 /* Open the settings page generated by Clay. */
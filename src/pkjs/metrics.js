@@ -0,0 +1,304 @@
+/**
+ * Phone-pushed metric bars. Providers registered here are polled periodically,
+ * and any values that changed since they were last sent are batched into a
+ * single binary RemoteMetrics frame. The watch shows each metric as its own bar.
+ */
+
+/* Must match the definitions in remote_metrics.h. */
+var MAX_REMOTE_METRICS = 3;
+var REMOTE_METRIC_LABEL_WIDTH = 8;
+var REMOTE_METRIC_REMOVE = 0xFFFF;
+
+/* Only characters in the watch's label font can be shown.
+This matches the characterRegex of the font resources in package.json. */
+var LABEL_CHARACTERS = /[ %0-9:ACDFJMNOSTWabcdeghilmnoprstuvy°¤-]/;
+
+/* Never send frames more often than this, no matter how often providers update. 
+Updates arriving within the batch delay of each other go in the same frame. */
+var MIN_SEND_INTERVAL_MS = 60000;
+var BATCH_DELAY_MS = 2000;
+var POLL_INTERVAL_MS = 900000; //15 minutes
+
+var providers = [];
+var lastSent = {};
+var pending = {};
+var lastSendTime = 0;
+var flushTimer = null;
+var sending = false;
+
+/**
+ * Converts a 0xRRGGBB color into the watch's 8-bit GColor value.
+ *
+ * @param hex: Color as a 24-bit integer.
+ */
+function toGColor8(hex) {
+	return 0xC0 | 
+		(((hex >> 22) & 0x3) << 4) | 
+		(((hex >> 14) & 0x3) << 2) | 
+		((hex >> 6) & 0x3);
+}
+
+/**
+ * Drops characters that the watch cannot display and shortens the label to fit.
+ * The watch limits the label by its UTF-8 length, and some of the allowed 
+ * characters take two bytes, so the bytes are counted rather than the characters.
+ *
+ * @param label: The label text.
+ */
+function sanitizeLabel(label) {
+	var result = '';
+	var i;
+
+	label = String(label);
+	for (i = 0; i < label.length; ++i) {
+		if (!LABEL_CHARACTERS.test(label[i])) {
+			continue;
+		}
+		if (labelBytes(result + label[i]).length > REMOTE_METRIC_LABEL_WIDTH - 1) {
+			break;
+		}
+		result += label[i];
+	}
+	return result;
+}
+
+/**
+ * Encodes the label as the bytes the watch expects (UTF-8).
+ *
+ * @param label: The label text.
+ */
+function labelBytes(label) {
+	var utf8 = unescape(encodeURIComponent(label));
+	var bytes = [];
+	var i;
+
+	for (i = 0; i < utf8.length; ++i) {
+		bytes.push(utf8.charCodeAt(i));
+	}
+	return bytes;
+}
+
+/**
+ * Builds a frame from the pending updates. See remote_metrics_decode in 
+ * remote_metrics.c for the layout.
+ *
+ * @param updates: Map of metric id to update.
+ */
+function encodeFrame(updates) {
+	var frame = [0];
+	var id;
+	var update;
+	var label;
+
+	for (id in updates) {
+		if (updates.hasOwnProperty(id)) {
+			update = updates[id];
+			label = labelBytes(update.label);
+			frame.push(Number(id), update.color, 
+				update.progress & 0xFF, (update.progress >> 8) & 0xFF, 
+				label.length);
+			frame = frame.concat(label);
+			++frame[0];
+		}
+	}
+	return frame;
+}
+
+/**
+ * Schedules the pending updates to be sent, leaving time for other updates 
+ * to join the same frame and respecting the minimum interval between frames.
+ */
+function scheduleFlush() {
+	var sinceLastSend = Date.now() - lastSendTime;
+
+	if (flushTimer || sending || Object.keys(pending).length === 0) {
+		return;
+	}
+
+	flushTimer = setTimeout(function() {
+		flushTimer = null;
+		flush();
+	}, Math.max(BATCH_DELAY_MS, MIN_SEND_INTERVAL_MS - sinceLastSend));
+}
+
+/**
+ * Sends all pending updates to the watch as one frame.
+ */
+function flush() {
+	var now = Date.now();
+	var updates = pending;
+
+	if (sending || Object.keys(updates).length === 0) {
+		return;
+	}
+
+	pending = {};
+	sending = true;
+	lastSendTime = now;
+
+	Pebble.sendAppMessage({'RemoteMetrics': encodeFrame(updates)}, function(e) {
+		console.log('Remote metrics sent to Pebble successfully.');
+		sending = false;
+		Object.keys(updates).forEach(function(id) {
+			if (updates[id].progress == REMOTE_METRIC_REMOVE) {
+				delete lastSent[id];
+			}
+			else {
+				lastSent[id] = updates[id];
+			}
+		});
+		scheduleFlush();
+	}, function(e) {
+		console.log('Error sending remote metrics to Pebble.');
+		sending = false;
+		/* Keep the failed updates unless they have since been superseded. */
+		Object.keys(updates).forEach(function(id) {
+			if (!pending.hasOwnProperty(id)) {
+				pending[id] = updates[id];
+			}
+		});
+		scheduleFlush();
+	});
+}
+
+/**
+ * Queues an update for a metric, unless it matches what the watch already shows.
+ *
+ * @param id: The metric id.
+ * @param color: The bar color, as 0xRRGGBB.
+ * @param progress: How full the bar is; 0.0 is empty, 1.0 is full.
+ * @param label: Text drawn at the end of the bar.
+ */
+function update(id, color, progress, label) {
+	var next = {
+		color: toGColor8(color),
+		progress: Math.max(0, Math.min(REMOTE_METRIC_REMOVE - 1, Math.round(progress * 1000))),
+		label: sanitizeLabel(label)
+	};
+	var previous = lastSent[id];
+
+	if (previous && previous.color == next.color && 
+		previous.progress == next.progress && previous.label == next.label) {
+		delete pending[id];
+		return;
+	}
+
+	pending[id] = next;
+	scheduleFlush();
+}
+
+/**
+ * Removes a metric's bar from the watch.
+ *
+ * @param id: The metric id.
+ */
+function remove(id) {
+	pending[id] = {color: 0, progress: REMOTE_METRIC_REMOVE, label: ''};
+	scheduleFlush();
+}
+
+/**
+ * Registers a provider for a metric bar.
+ *
+ * @param color: The bar color, as 0xRRGGBB.
+ * @param poll: Function called periodically with a callback(progress, label).
+ *	The callback may be called at any time, or not at all if the value is unavailable.
+ */
+function registerProvider(color, poll) {
+	var id = providers.length;
+
+	if (id >= MAX_REMOTE_METRICS) {
+		console.log('Too many remote metric providers; ignoring.');
+		return;
+	}
+
+	providers.push({id: id, color: color, poll: poll});
+}
+
+/**
+ * Polls every provider for its current value.
+ */
+function pollAll() {
+	providers.forEach(function(provider) {
+		provider.poll(function(progress, label) {
+			update(provider.id, provider.color, progress, label);
+		});
+	});
+}
+
+/**
+ * Starts polling the providers. Metrics left on the watch by providers 
+ * that are no longer registered are removed.
+ */
+function start() {
+	var previousCount = Number(localStorage.getItem('remoteMetricProviders')) || 0;
+	var id;
+
+	/* The watch keeps metrics between launches, so make sure none are left 
+	over from providers that were removed. */
+	for (id = providers.length; id < previousCount; ++id) {
+		remove(id);
+	}
+	localStorage.setItem('remoteMetricProviders', providers.length);
+
+	if (providers.length > 0) {
+		pollAll();
+		setInterval(pollAll, POLL_INTERVAL_MS);
+	}
+}
+
+/**
+ * Creates a provider that reads a number from a JSON endpoint.
+ *
+ * @param url: The URL to fetch, e.g. a service on the local network.
+ * @param path: Dot-separated path to the value within the JSON.
+ * @param min: Value shown as an empty bar.
+ * @param max: Value shown as a full bar.
+ * @param suffix: Text appended to the value in the label.
+ */
+function httpJsonProvider(url, path, min, max, suffix) {
+	return function(callback) {
+		var xhr = new XMLHttpRequest();
+
+		xhr.onload = function() {
+			var value;
+
+			try {
+				value = path.split('.').reduce(function(object, key) {
+					return object[key];
+				}, JSON.parse(this.responseText));
+			}
+			catch (e) {
+				console.log('Could not read ' + path + ' from ' + url + '.');
+				return;
+			}
+
+			callback((value - min) / (max - min), Math.round(value) + suffix);
+		};
+
+		xhr.open('GET', url);
+		xhr.send();
+	};
+}
+
+/**
+ * Creates a provider for how far through the current week (Monday to Sunday) it is.
+ * The label is the ISO week number.
+ */
+function weekProvider() {
+	return function(callback) {
+		var now = new Date();
+		var dayOfWeek = (now.getDay() + 6) % 7;
+		var startOfWeek = new Date(now.getFullYear(), now.getMonth(), now.getDate() - dayOfWeek);
+		var thursday = new Date(startOfWeek.getFullYear(), startOfWeek.getMonth(), startOfWeek.getDate() + 3);
+		var startOfYear = new Date(thursday.getFullYear(), 0, 1);
+		var week = 1 + Math.floor((thursday - startOfYear) / (7 * 24 * 3600 * 1000));
+
+		callback((now - startOfWeek) / (7 * 24 * 3600 * 1000), 'W' + week);
+	};
+}
+
+module.exports.registerProvider = registerProvider;
+module.exports.start = start;
+module.exports.httpJsonProvider = httpJsonProvider;
+module.exports.weekProvider = weekProvider;
@@ -21,9 +21,12 @@ function getOpenWeatherData(pos) {
 		/* responseText will contain a JSON object with data info. */
 		var json = JSON.parse(this.responseText);
 
-		/* Assemble dictionary to send. */
+		/* Assemble dictionary to send. The location is sent along so the watch can 
+		work out sunrise and sunset itself, in hundredths of a degree. */
 		var dictionary = {
-			'Temperature': json.main.temp
+			'Temperature': json.main.temp,
+			'Latitude': Math.round(pos.coords.latitude * 100),
+			'Longitude': Math.round(pos.coords.longitude * 100)
 		};
 
 		/* Send the message to the watch. */
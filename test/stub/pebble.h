@@ -0,0 +1,483 @@
+#pragma once
+
+/*
+ * Host stand-in for the parts of the Pebble C SDK that the watchface uses, so
+ * that src/c can be built and drawn on a desktop machine by the sweep harness.
+ * Drawing goes to a software frame buffer; the clock, health, battery and
+ * persistent storage are controlled from stub.h.
+ *
+ * Build with one of -DSTUB_PLATFORM_APLITE, -DSTUB_PLATFORM_BASALT or
+ * -DSTUB_PLATFORM_DIORITE, which differ in the same ways as the watches: color
+ * or black and white, and whether the timeline quick view exists.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+/*** Platform ***/
+#if defined(STUB_PLATFORM_BASALT)
+#define PBL_COLOR 1
+#define PBL_PLATFORM_BASALT 1
+#define STUB_HAS_unobstructed_area_service_subscribe 1
+#elif defined(STUB_PLATFORM_DIORITE)
+#define PBL_BW 1
+#define PBL_PLATFORM_DIORITE 1
+#define STUB_HAS_unobstructed_area_service_subscribe 1
+#elif defined(STUB_PLATFORM_APLITE)
+#define PBL_BW 1
+#define PBL_PLATFORM_APLITE 1
+#else
+#error "Define STUB_PLATFORM_APLITE, STUB_PLATFORM_BASALT or STUB_PLATFORM_DIORITE."
+#endif
+
+#define PBL_RECT 1
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+
+/* Only APIs with a STUB_HAS_ definition exist; anything else is 0 in #if. */
+#define PBL_API_EXISTS(api) STUB_HAS_##api
+
+#if defined(PBL_COLOR)
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_false)
+#else
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_true)
+#endif
+
+/*** Clock ***/
+
+/* The watch's clock is the stub's, and its local time is UTC, so that
+results do not depend on the host. */
+time_t stub_time(time_t *tloc);
+struct tm *stub_localtime(const time_t *timep);
+#define time(tloc) stub_time(tloc)
+#define localtime(timep) stub_localtime(timep)
+
+#define SECONDS_PER_MINUTE 60
+#define SECONDS_PER_HOUR 3600
+#define SECONDS_PER_DAY 86400
+#define MINUTES_PER_HOUR 60
+
+typedef enum {
+	SECOND_UNIT = 1 << 0,
+	MINUTE_UNIT = 1 << 1,
+	HOUR_UNIT = 1 << 2,
+	DAY_UNIT = 1 << 3,
+	MONTH_UNIT = 1 << 4,
+	YEAR_UNIT = 1 << 5
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+bool clock_is_24h_style(void);
+time_t time_start_of_today(void);
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+
+/*** Utilities ***/
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+typedef enum {
+	APP_LOG_LEVEL_ERROR = 1,
+	APP_LOG_LEVEL_WARNING = 50,
+	APP_LOG_LEVEL_INFO = 100,
+	APP_LOG_LEVEL_DEBUG = 200,
+	APP_LOG_LEVEL_DEBUG_VERBOSE = 255
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...)
+	__attribute__((format(printf, 4, 5)));
+#define APP_LOG(level, fmt, ...) app_log(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+int32_t atan2_lookup(int16_t y, int16_t x);
+
+/*** Graphics types ***/
+typedef struct GPoint {
+	int16_t x;
+	int16_t y;
+} GPoint;
+
+typedef struct GSize {
+	int16_t w;
+	int16_t h;
+} GSize;
+
+typedef struct GRect {
+	GPoint origin;
+	GSize size;
+} GRect;
+
+#define GPoint(x, y) ((GPoint){ (x), (y) })
+#define GSize(w, h) ((GSize){ (w), (h) })
+#define GRect(x, y, w, h) ((GRect){ { (x), (y) }, { (w), (h) } })
+
+bool gsize_equal(const GSize *size_a, const GSize *size_b);
+
+typedef union GColor8 {
+	uint8_t argb;
+	struct {
+		uint8_t b:2;
+		uint8_t g:2;
+		uint8_t r:2;
+		uint8_t a:2;
+	};
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorARGB8(argb_value) ((GColor8){ .argb = (argb_value) })
+#define GColorFromHEX(hex) GColorARGB8(0xC0 | ((((hex) >> 22) & 0x3) << 4) | \
+	((((hex) >> 14) & 0x3) << 2) | (((hex) >> 6) & 0x3))
+bool gcolor_equal(GColor8 x, GColor8 y);
+
+#define GColorClear GColorARGB8(0x00)
+#define GColorBlack GColorARGB8(0xC0)
+#define GColorOxfordBlue GColorARGB8(0xC1)
+#define GColorDukeBlue GColorARGB8(0xC2)
+#define GColorDarkGreen GColorARGB8(0xC4)
+#define GColorVividCerulean GColorARGB8(0xCB)
+#define GColorImperialPurple GColorARGB8(0xD1)
+#define GColorDarkGray GColorARGB8(0xD5)
+#define GColorLightGray GColorARGB8(0xEA)
+#define GColorSpringBud GColorARGB8(0xEC)
+#define GColorRed GColorARGB8(0xF0)
+#define GColorOrange GColorARGB8(0xF4)
+#define GColorChromeYellow GColorARGB8(0xF8)
+#define GColorRajah GColorARGB8(0xF9)
+#define GColorYellow GColorARGB8(0xFC)
+#define GColorWhite GColorARGB8(0xFF)
+
+typedef enum {
+	GCornerNone = 0,
+	GCornerTopLeft = 1 << 0,
+	GCornerTopRight = 1 << 1,
+	GCornerBottomLeft = 1 << 2,
+	GCornerBottomRight = 1 << 3,
+	GCornersAll = 0xF,
+	GCornersTop = GCornerTopLeft | GCornerTopRight,
+	GCornersBottom = GCornerBottomLeft | GCornerBottomRight,
+	GCornersLeft = GCornerTopLeft | GCornerBottomLeft,
+	GCornersRight = GCornerTopRight | GCornerBottomRight
+} GCornerMask;
+
+typedef enum {
+	GCompOpAssign,
+	GCompOpAssignInverted,
+	GCompOpOr,
+	GCompOpAnd,
+	GCompOpClear,
+	GCompOpSet
+} GCompOp;
+
+typedef enum {
+	GBitmapFormat1Bit,
+	GBitmapFormat8Bit,
+	GBitmapFormat1BitPalette,
+	GBitmapFormat2BitPalette,
+	GBitmapFormat4BitPalette,
+	GBitmapFormat8BitCircular
+} GBitmapFormat;
+
+typedef enum {
+	GTextOverflowModeWordWrap,
+	GTextOverflowModeTrailingEllipsis,
+	GTextOverflowModeFill
+} GTextOverflowMode;
+
+typedef enum {
+	GTextAlignmentLeft,
+	GTextAlignmentCenter,
+	GTextAlignmentRight
+} GTextAlignment;
+
+typedef struct GContext GContext;
+typedef struct GBitmap GBitmap;
+typedef struct GFontStub *GFont;
+typedef struct GTextAttributes GTextAttributes;
+
+/*** Graphics ***/
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_draw_rect(GContext *ctx, GRect rect);
+void graphics_draw_round_rect(GContext *ctx, GRect rect, uint16_t radius);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+						const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+						GTextAttributes *text_attributes);
+GSize graphics_text_layout_get_content_size(const char *text, GFont const font, const GRect box,
+											const GTextOverflowMode overflow_mode,
+											const GTextAlignment alignment);
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+void gbitmap_destroy(GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds);
+
+/*** Fonts and resources ***/
+enum {
+	RESOURCE_ID_IMAGE_MENU_ICON = 1,
+	RESOURCE_ID_FONT_OXYGEN_MONO_27,
+	RESOURCE_ID_FONT_OXYGEN_MONO_20,
+	RESOURCE_ID_FONT_OXYGEN_MONO_17
+};
+
+typedef uint32_t ResHandle;
+ResHandle resource_get_handle(uint32_t resource_id);
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+
+/*** Layers and windows ***/
+typedef struct Layer Layer;
+typedef struct Window Window;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_mark_dirty(Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+void layer_add_child(Layer *parent, Layer *child);
+
+typedef void (*WindowHandler)(Window *window);
+typedef struct {
+	WindowHandler load;
+	WindowHandler appear;
+	WindowHandler disappear;
+	WindowHandler unload;
+} WindowHandlers;
+
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_background_color(Window *window, GColor background_color);
+Layer *window_get_root_layer(const Window *window);
+void window_stack_push(Window *window, bool animated);
+
+typedef int32_t AnimationProgress;
+#define ANIMATION_NORMALIZED_MAX 65535
+
+/* Only declared where the watch has the timeline quick view, so that a use 
+that is not guarded by PBL_API_EXISTS fails to build. */
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+GRect layer_get_unobstructed_bounds(const Layer *layer);
+
+typedef void (*UnobstructedAreaWillChangeHandler)(GRect final_unobstructed_screen_area, void *context);
+typedef void (*UnobstructedAreaChangeHandler)(AnimationProgress progress, void *context);
+typedef void (*UnobstructedAreaDidChangeHandler)(void *context);
+typedef struct {
+	UnobstructedAreaWillChangeHandler will_change;
+	UnobstructedAreaChangeHandler change;
+	UnobstructedAreaDidChangeHandler did_change;
+} UnobstructedAreaHandlers;
+
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context);
+void unobstructed_area_service_unsubscribe(void);
+#endif
+
+/*** Services ***/
+typedef struct {
+	uint8_t charge_percent;
+	bool is_charging;
+	bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+typedef int32_t HealthValue;
+typedef enum {
+	HealthMetricStepCount,
+	HealthMetricActiveSeconds,
+	HealthMetricWalkedDistanceMeters,
+	HealthMetricSleepSeconds
+} HealthMetric;
+
+typedef enum {
+	HealthEventSignificantUpdate,
+	HealthEventMovementUpdate,
+	HealthEventSleepUpdate,
+	HealthEventMetricAlert,
+	HealthEventHeartRateUpdate
+} HealthEventType;
+
+typedef enum {
+	HealthServiceAccessibilityMaskAvailable = 1 << 0,
+	HealthServiceAccessibilityMaskNoPermission = 1 << 1,
+	HealthServiceAccessibilityMaskNotSupported = 1 << 2,
+	HealthServiceAccessibilityMaskNotAvailable = 1 << 3
+} HealthServiceAccessibilityMask;
+
+typedef enum {
+	HealthActivityNone = 0,
+	HealthActivitySleep = 1 << 0,
+	HealthActivityRestfulSleep = 1 << 1,
+	HealthActivityWalk = 1 << 2,
+	HealthActivityRun = 1 << 3
+} HealthActivity;
+typedef uint32_t HealthActivityMask;
+
+typedef struct {
+	uint8_t steps;
+	uint8_t orientation;
+	uint16_t vmc;
+	bool is_invalid:1;
+	uint8_t light:3;
+	uint8_t padding:4;
+	uint8_t heart_rate_bpm;
+	uint8_t reserved[6];
+} HealthMinuteData;
+
+typedef void (*HealthEventHandler)(HealthEventType event, void *context);
+bool health_service_events_subscribe(HealthEventHandler handler, void *context);
+bool health_service_events_unsubscribe(void);
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric,
+																time_t time_start, time_t time_end);
+HealthValue health_service_sum_today(HealthMetric metric);
+HealthValue health_service_sum(HealthMetric metric, time_t time_start, time_t time_end);
+HealthActivityMask health_service_peek_current_activities(void);
+uint32_t health_service_get_minute_history(HealthMinuteData *minute_data, uint32_t max_records,
+										   time_t *time_start, time_t *time_end);
+
+void light_enable_interaction(void);
+
+/*** Timers ***/
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer_handle);
+
+/*** Persistent storage ***/
+#define PERSIST_DATA_MAX_LENGTH 256
+#define PERSIST_STRING_MAX_LENGTH PERSIST_DATA_MAX_LENGTH
+
+bool persist_exists(const uint32_t key);
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+int32_t persist_read_int(const uint32_t key);
+int persist_write_int(const uint32_t key, const int32_t value);
+int persist_delete(const uint32_t key);
+
+/*** AppMessage ***/
+typedef enum {
+	TUPLE_BYTE_ARRAY = 0,
+	TUPLE_CSTRING = 1,
+	TUPLE_UINT = 2,
+	TUPLE_INT = 3
+} TupleType;
+
+typedef struct __attribute__((__packed__)) {
+	uint32_t key;
+	TupleType type:8;
+	uint16_t length;
+	union {
+		uint8_t data[0];
+		char cstring[0];
+		uint8_t uint8;
+		uint16_t uint16;
+		uint32_t uint32;
+		int8_t int8;
+		int16_t int16;
+		int32_t int32;
+	} value[];
+} Tuple;
+
+typedef struct DictionaryIterator DictionaryIterator;
+typedef enum {
+	DICT_OK = 0,
+	DICT_NOT_ENOUGH_STORAGE = 1 << 1,
+	DICT_INVALID_ARGS = 1 << 2
+} DictionaryResult;
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key);
+Tuple *dict_read_first(DictionaryIterator *iter);
+Tuple *dict_read_next(DictionaryIterator *iter);
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value);
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value);
+
+typedef enum {
+	APP_MSG_OK = 0,
+	APP_MSG_SEND_TIMEOUT = 1 << 1,
+	APP_MSG_SEND_REJECTED = 1 << 2,
+	APP_MSG_NOT_CONNECTED = 1 << 3,
+	APP_MSG_APP_NOT_RUNNING = 1 << 4,
+	APP_MSG_INVALID_ARGS = 1 << 5,
+	APP_MSG_BUSY = 1 << 6
+} AppMessageResult;
+
+typedef void (*AppMessageInboxReceived)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageInboxDropped)(AppMessageResult reason, void *context);
+typedef void (*AppMessageOutboxSent)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageOutboxFailed)(DictionaryIterator *iterator, AppMessageResult reason, void *context);
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
+AppMessageResult app_message_outbox_send(void);
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+void app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback);
+void app_message_register_outbox_sent(AppMessageOutboxSent sent_callback);
+void app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback);
+
+/* Message keys, laid out as the SDK would from package.json. */
+extern const uint32_t MESSAGE_KEY_FetchTemperature;
+extern const uint32_t MESSAGE_KEY_Temperature;
+extern const uint32_t MESSAGE_KEY_SettingsMessage;
+extern const uint32_t MESSAGE_KEY_BarCheckboxes;
+extern const uint32_t MESSAGE_KEY_BarColors;
+extern const uint32_t MESSAGE_KEY_BackgroundColor;
+extern const uint32_t MESSAGE_KEY_TextColor;
+extern const uint32_t MESSAGE_KEY_TextOutlineColor;
+extern const uint32_t MESSAGE_KEY_TemperatureScale;
+extern const uint32_t MESSAGE_KEY_TemperatureMinF;
+extern const uint32_t MESSAGE_KEY_TemperatureMaxF;
+extern const uint32_t MESSAGE_KEY_TemperatureMinC;
+extern const uint32_t MESSAGE_KEY_TemperatureMaxC;
+extern const uint32_t MESSAGE_KEY_BarStyle;
+extern const uint32_t MESSAGE_KEY_RemoteMetrics;
+extern const uint32_t MESSAGE_KEY_StepsSparkline;
+extern const uint32_t MESSAGE_KEY_QuietModeSleep;
+extern const uint32_t MESSAGE_KEY_QuietModeWindow;
+extern const uint32_t MESSAGE_KEY_QuietStartHour;
+extern const uint32_t MESSAGE_KEY_QuietEndHour;
+extern const uint32_t MESSAGE_KEY_Latitude;
+extern const uint32_t MESSAGE_KEY_Longitude;
+extern const uint32_t MESSAGE_KEY_BackgroundWorker;
+extern const uint32_t MESSAGE_KEY_PhoneReady;
+
+/*** Background worker ***/
+typedef enum {
+	APP_WORKER_RESULT_SUCCESS = 0,
+	APP_WORKER_RESULT_NO_WORKER = 1,
+	APP_WORKER_RESULT_DIFFERENT_APP = 2,
+	APP_WORKER_RESULT_NOT_RUNNING = 3,
+	APP_WORKER_RESULT_ALREADY_RUNNING = 4,
+	APP_WORKER_RESULT_ASKING_CONFIRMATION = 5
+} AppWorkerResult;
+
+AppWorkerResult app_worker_launch(void);
+AppWorkerResult app_worker_kill(void);
+bool app_worker_is_running(void);
@@ -0,0 +1,1210 @@
+#include <pebble.h>
+#include <math.h>
+#include <stdarg.h>
+#include "stub.h"
+
+/*
+ * Host implementation of the Pebble SDK stand-in. Drawing is done in software
+ * into a frame buffer laid out as on the watch: one byte per pixel in GColor8
+ * format on color platforms, or one bit per pixel (set is white, least
+ * significant bit leftmost) in rows of 20 bytes on black and white platforms.
+ *
+ * The shapes follow the SDK closely enough for bars to line up, but the text
+ * is drawn with made-up glyphs: every character gets a fixed 5x7 pattern
+ * scaled to the font size. Frames can be compared with each other, not with
+ * screenshots from a watch.
+ */
+
+/*** Constants ***/
+#define SCREEN_W PBL_DISPLAY_WIDTH
+#define SCREEN_H PBL_DISPLAY_HEIGHT
+
+#if defined(PBL_COLOR)
+#define FRAME_BYTES_PER_ROW SCREEN_W
+#define FRAME_FORMAT GBitmapFormat8Bit
+#else
+#define FRAME_BYTES_PER_ROW 20
+#define FRAME_FORMAT GBitmapFormat1Bit
+#endif
+
+#define FRAME_WORDS ((FRAME_BYTES_PER_ROW * SCREEN_H + 3) / 4)
+
+#define MAX_TIMERS 64
+#define MAX_PERSIST_KEYS 64
+#define E_DOES_NOT_EXIST (-9)
+
+/*** Types ***/
+struct GBitmap {
+	uint8_t *data;
+	uint16_t bytes_per_row;
+	GBitmapFormat format;
+	GRect bounds;
+};
+
+struct GContext {
+	GColor fill_color;
+	GColor stroke_color;
+	GColor text_color;
+	GCompOp compositing_mode;
+	bool frame_buffer_captured;
+};
+
+struct GFontStub {
+	int size;
+};
+
+struct Layer {
+	GRect frame;
+	LayerUpdateProc update_proc;
+	Layer *parent;
+	Layer *first_child;
+	Layer *next_sibling;
+};
+
+struct Window {
+	Layer *root_layer;
+	GColor background_color;
+	WindowHandlers handlers;
+};
+
+struct AppTimer {
+	bool active;
+	uint32_t timeout_ms;
+	AppTimerCallback callback;
+	void *data;
+};
+
+struct DictionaryIterator {
+	int unused;
+};
+
+typedef struct {
+	bool used;
+	uint32_t key;
+	int size;
+	uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} persist_entry_t;
+
+/*** Internal Global Variables ***/
+
+/* Word aligned, as on the watch, since the app may write it a word at a time. */
+static uint32_t frame_words[FRAME_WORDS];
+static uint32_t captured_words[FRAME_WORDS];
+static GBitmap frame_buffer = {
+	.data = (uint8_t *) frame_words,
+	.bytes_per_row = FRAME_BYTES_PER_ROW,
+	.format = FRAME_FORMAT,
+	.bounds = { { 0, 0 }, { SCREEN_W, SCREEN_H } }
+};
+static GContext context;
+static stub_cost_t cost;
+
+static time_t now;
+static bool is_24h_style = true;
+static int steps_today;
+static HealthActivityMask activities;
+static BatteryChargeState battery = { .charge_percent = 50 };
+
+static TickHandler tick_handler;
+static HealthEventHandler health_handler;
+static void *health_context;
+static BatteryStateHandler battery_handler;
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+static UnobstructedAreaHandlers unobstructed_handlers;
+static void *unobstructed_context;
+static int unobstructed_height = SCREEN_H;
+#endif
+
+static struct AppTimer timers[MAX_TIMERS];
+static persist_entry_t persist_entries[MAX_PERSIST_KEYS];
+static int persist_truncated_writes;
+
+static struct DictionaryIterator outbox_iterator;
+static int outbox_messages_sent;
+static bool worker_running;
+
+/*** Clock ***/
+
+time_t stub_time(time_t *tloc) {
+	if (tloc) {
+		*tloc = now;
+	}
+	return now;
+}
+
+struct tm *stub_localtime(const time_t *timep) {
+	static struct tm result;
+	gmtime_r(timep, &result);
+	return &result;
+}
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+	tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+	tick_handler = NULL;
+}
+
+bool clock_is_24h_style(void) {
+	return is_24h_style;
+}
+
+time_t time_start_of_today(void) {
+	return now - now % SECONDS_PER_DAY;
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+	if (tloc) {
+		*tloc = now;
+	}
+	if (out_ms) {
+		*out_ms = 0;
+	}
+	return 0;
+}
+
+/*** Utilities ***/
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+	if (!getenv("STUB_LOG")) {
+		return;
+	}
+
+	va_list args;
+	va_start(args, fmt);
+	fprintf(stderr, "[%s:%d] ", src_filename, src_line_number);
+	vfprintf(stderr, fmt, args);
+	fprintf(stderr, "\n");
+	va_end(args);
+}
+
+int32_t sin_lookup(int32_t angle) {
+	return lround(sin(angle * 2 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+	return lround(cos(angle * 2 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t atan2_lookup(int16_t y, int16_t x) {
+	double angle = atan2(y, x);
+	if (angle < 0) {
+		angle += 2 * M_PI;
+	}
+	return lround(angle * TRIG_MAX_ANGLE / (2 * M_PI)) % TRIG_MAX_ANGLE;
+}
+
+bool gsize_equal(const GSize *size_a, const GSize *size_b) {
+	return size_a->w == size_b->w && size_a->h == size_b->h;
+}
+
+bool gcolor_equal(GColor8 x, GColor8 y) {
+	return x.argb == y.argb || (x.a == 0 && y.a == 0);
+}
+
+/*** Pixels ***/
+
+/**
+ * Returns whether a color comes out white on a black and white screen: the
+ * nearer of black and white, so light gray is white and dark gray is black.
+ */
+static bool is_white(GColor color) {
+	return (color.r * 2 + color.g * 5 + color.b + 3) / 6 >= 2;
+}
+
+static bool in_screen(int x, int y) {
+	return x >= 0 && y >= 0 && x < SCREEN_W && y < SCREEN_H;
+}
+
+static void write_pixel(int x, int y, GColor color) {
+	if (!in_screen(x, y) || color.a == 0) {
+		return;
+	}
+	++cost.pixels;
+
+	uint8_t *row = frame_buffer.data + y * FRAME_BYTES_PER_ROW;
+#if defined(PBL_COLOR)
+	row[x] = color.argb | 0xC0;
+#else
+	if (is_white(color)) {
+		row[x / 8] |= 1 << (x % 8);
+	}
+	else {
+		row[x / 8] &= ~(1 << (x % 8));
+	}
+#endif
+}
+
+/*** Graphics ***/
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+	ctx->fill_color = color;
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+	ctx->stroke_color = color;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+	ctx->text_color = color;
+}
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) {
+	ctx->compositing_mode = mode;
+}
+
+/**
+ * Counts a drawing call, and returns whether it can draw: as on the watch,
+ * nothing is drawn while the app holds the frame buffer.
+ */
+static bool begin_call(GContext *ctx) {
+	++cost.calls;
+	return !ctx->frame_buffer_captured;
+}
+
+/**
+ * Returns whether a pixel of a rectangle falls outside its rounded corners.
+ * A corner pixel is outside if its center is further than the radius from
+ * the center of the corner's circle.
+ */
+static bool outside_corners(int x, int y, GRect rect, int radius, GCornerMask corners) {
+	int from_left = x - rect.origin.x;
+	int from_right = rect.origin.x + rect.size.w - 1 - x;
+	int from_top = y - rect.origin.y;
+	int from_bottom = rect.origin.y + rect.size.h - 1 - y;
+
+	int dx = -1, dy = -1;
+	if ((corners & GCornerTopLeft) && from_left < radius && from_top < radius) {
+		dx = from_left, dy = from_top;
+	}
+	else if ((corners & GCornerTopRight) && from_right < radius && from_top < radius) {
+		dx = from_right, dy = from_top;
+	}
+	else if ((corners & GCornerBottomLeft) && from_left < radius && from_bottom < radius) {
+		dx = from_left, dy = from_bottom;
+	}
+	else if ((corners & GCornerBottomRight) && from_right < radius && from_bottom < radius) {
+		dx = from_right, dy = from_bottom;
+	}
+	if (dx < 0) {
+		return false;
+	}
+
+	int a = 2 * (radius - dx) - 1;
+	int b = 2 * (radius - dy) - 1;
+	return a * a + b * b > 4 * radius * radius;
+}
+
+static bool in_round_rect(int x, int y, GRect rect, int radius, GCornerMask corners) {
+	return x >= rect.origin.x && y >= rect.origin.y &&
+		x < rect.origin.x + rect.size.w && y < rect.origin.y + rect.size.h &&
+		!outside_corners(x, y, rect, radius, corners);
+}
+
+/* Rectangles with a negative size are drawn as empty. The radius is limited to
+half the shorter side. */
+static int clamp_radius(GRect rect, int radius) {
+	return MIN(radius, MIN(rect.size.w, rect.size.h) / 2);
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+	if (!begin_call(ctx) || rect.size.w <= 0 || rect.size.h <= 0) {
+		return;
+	}
+
+	int radius = clamp_radius(rect, corner_radius);
+	for (int y = MAX(rect.origin.y, 0); y < MIN(rect.origin.y + rect.size.h, SCREEN_H); ++y) {
+		for (int x = MAX(rect.origin.x, 0); x < MIN(rect.origin.x + rect.size.w, SCREEN_W); ++x) {
+			if (!outside_corners(x, y, rect, radius, corner_mask)) {
+				write_pixel(x, y, ctx->fill_color);
+			}
+		}
+	}
+}
+
+/**
+ * Draws the one pixel wide edge of a rectangle with the given corners: every
+ * pixel of the shape next to one that is not.
+ */
+static void stroke_round_rect(GContext *ctx, GRect rect, int radius) {
+	if (rect.size.w <= 0 || rect.size.h <= 0) {
+		return;
+	}
+
+	radius = clamp_radius(rect, radius);
+	for (int y = MAX(rect.origin.y, 0); y < MIN(rect.origin.y + rect.size.h, SCREEN_H); ++y) {
+		for (int x = MAX(rect.origin.x, 0); x < MIN(rect.origin.x + rect.size.w, SCREEN_W); ++x) {
+			if (!in_round_rect(x, y, rect, radius, GCornersAll)) {
+				continue;
+			}
+			if (!in_round_rect(x - 1, y, rect, radius, GCornersAll) ||
+				!in_round_rect(x + 1, y, rect, radius, GCornersAll) ||
+				!in_round_rect(x, y - 1, rect, radius, GCornersAll) ||
+				!in_round_rect(x, y + 1, rect, radius, GCornersAll)) {
+				write_pixel(x, y, ctx->stroke_color);
+			}
+		}
+	}
+}
+
+void graphics_draw_rect(GContext *ctx, GRect rect) {
+	if (begin_call(ctx)) {
+		stroke_round_rect(ctx, rect, 0);
+	}
+}
+
+void graphics_draw_round_rect(GContext *ctx, GRect rect, uint16_t radius) {
+	if (begin_call(ctx)) {
+		stroke_round_rect(ctx, rect, radius);
+	}
+}
+
+/**
+ * Reads a pixel of a bitmap. 1-bit pixels are returned as white or black.
+ */
+static GColor read_bitmap_pixel(const GBitmap *bitmap, int x, int y) {
+	const uint8_t *row = bitmap->data + y * bitmap->bytes_per_row;
+	if (bitmap->format == GBitmapFormat1Bit) {
+		return ((row[x / 8] >> (x % 8)) & 1) ? GColorWhite : GColorBlack;
+	}
+	return (GColor) { .argb = row[x] };
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+	if (!begin_call(ctx) || !bitmap) {
+		return;
+	}
+
+	GRect source = bitmap->bounds;
+	if (source.size.w <= 0 || source.size.h <= 0) {
+		return;
+	}
+
+	/* The bitmap is tiled to fill the rectangle. */
+	for (int y = MAX(rect.origin.y, 0); y < MIN(rect.origin.y + rect.size.h, SCREEN_H); ++y) {
+		for (int x = MAX(rect.origin.x, 0); x < MIN(rect.origin.x + rect.size.w, SCREEN_W); ++x) {
+			GColor pixel = read_bitmap_pixel(bitmap,
+				source.origin.x + (x - rect.origin.x) % source.size.w,
+				source.origin.y + (y - rect.origin.y) % source.size.h);
+			bool white = is_white(pixel);
+
+			switch (ctx->compositing_mode) {
+				case GCompOpAssign:
+					write_pixel(x, y, (GColor) { .argb = pixel.argb | 0xC0 });
+					break;
+				case GCompOpAssignInverted:
+					write_pixel(x, y, white ? GColorBlack : GColorWhite);
+					break;
+				case GCompOpOr:
+					/* White source pixels are painted, black ones are clear. */
+					if (white) {
+						write_pixel(x, y, GColorWhite);
+					}
+					break;
+				case GCompOpAnd:
+					if (!white) {
+						write_pixel(x, y, GColorBlack);
+					}
+					break;
+				case GCompOpClear:
+					/* White source pixels paint black. */
+					if (white) {
+						write_pixel(x, y, GColorBlack);
+					}
+					break;
+				case GCompOpSet:
+#if defined(PBL_COLOR)
+					/* Blends by the source's alpha; clear pixels are skipped. */
+					write_pixel(x, y, pixel);
+#else
+					/* Black source pixels paint white. */
+					if (!white) {
+						write_pixel(x, y, GColorWhite);
+					}
+#endif
+					break;
+			}
+		}
+	}
+}
+
+/*** Text ***/
+
+/**
+ * Decodes the next UTF-8 character of a string.
+ */
+static uint32_t next_codepoint(const char **text) {
+	const uint8_t *s = (const uint8_t *) *text;
+	uint32_t codepoint = s[0];
+	int length = 1;
+
+	if (s[0] >= 0xF0 && s[1] && s[2] && s[3]) {
+		codepoint = ((s[0] & 0x07) << 18) | ((s[1] & 0x3F) << 12) | ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+		length = 4;
+	}
+	else if (s[0] >= 0xE0 && s[1] && s[2]) {
+		codepoint = ((s[0] & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+		length = 3;
+	}
+	else if (s[0] >= 0xC0 && s[1]) {
+		codepoint = ((s[0] & 0x1F) << 6) | (s[1] & 0x3F);
+		length = 2;
+	}
+
+	*text += length;
+	return codepoint;
+}
+
+static int count_codepoints(const char *text) {
+	int count = 0;
+	while (*text) {
+		next_codepoint(&text);
+		++count;
+	}
+	return count;
+}
+
+/* Every glyph is one advance wide and one line high. */
+static int glyph_advance(GFont font) {
+	return font->size * 3 / 5;
+}
+
+static int line_height(GFont font) {
+	return font->size + font->size / 5;
+}
+
+/**
+ * Returns a fixed 5x7 pattern for a character, one bit per cell.
+ */
+static uint64_t glyph_pattern(uint32_t codepoint) {
+	if (codepoint == ' ') {
+		return 0;
+	}
+
+	uint64_t hash = (codepoint + 1) * 0x9E3779B97F4A7C15ull;
+	hash ^= hash >> 29;
+	hash *= 0xBF58476D1CE4E5B9ull;
+	hash ^= hash >> 32;
+	return hash & ((1ull << 35) - 1);
+}
+
+/**
+ * Draws a character's pattern scaled to its cell, leaving a margin of one
+ * pixel on each side and the top fifth of the line for the ascent. Only
+ * pixels within the clip rectangle are drawn.
+ */
+static void draw_glyph(uint32_t codepoint, GFont font, int cell_x, int cell_y, GRect clip, GColor color) {
+	uint64_t pattern = glyph_pattern(codepoint);
+	int glyph_w = glyph_advance(font) - 2;
+	int glyph_top = font->size / 5;
+	int glyph_h = line_height(font) - glyph_top;
+
+	for (int py = 0; py < glyph_h; ++py) {
+		int y = cell_y + glyph_top + py;
+		if (y < clip.origin.y || y >= clip.origin.y + clip.size.h) {
+			continue;
+		}
+		for (int px = 0; px < glyph_w; ++px) {
+			int x = cell_x + 1 + px;
+			if (x < clip.origin.x || x >= clip.origin.x + clip.size.w) {
+				continue;
+			}
+			int bit = (py * 7 / glyph_h) * 5 + px * 5 / glyph_w;
+			if ((pattern >> bit) & 1) {
+				write_pixel(x, y, color);
+			}
+		}
+	}
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+						const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+						GTextAttributes *text_attributes) {
+	if (!begin_call(ctx) || !text || !font) {
+		return;
+	}
+
+	/* All on one line, aligned in the box and clipped to it. */
+	int text_w = count_codepoints(text) * glyph_advance(font);
+	int x = box.origin.x;
+	if (alignment == GTextAlignmentCenter) {
+		x += (box.size.w - text_w) / 2;
+	}
+	else if (alignment == GTextAlignmentRight) {
+		x += box.size.w - text_w;
+	}
+
+	while (*text) {
+		draw_glyph(next_codepoint(&text), font, x, box.origin.y, box, ctx->text_color);
+		x += glyph_advance(font);
+	}
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont const font, const GRect box,
+											const GTextOverflowMode overflow_mode,
+											const GTextAlignment alignment) {
+	++cost.calls;
+	if (!text || !font) {
+		return GSize(0, 0);
+	}
+	return GSize(count_codepoints(text) * glyph_advance(font), line_height(font));
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+	++cost.calls;
+	if (ctx->frame_buffer_captured) {
+		return NULL;
+	}
+
+	ctx->frame_buffer_captured = true;
+	memcpy(captured_words, frame_words, sizeof(frame_words));
+	return &frame_buffer;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+	if (!ctx->frame_buffer_captured || buffer != &frame_buffer) {
+		return false;
+	}
+
+	/* What the app wrote directly is counted by the words it changed. */
+	for (int i = 0; i < FRAME_WORDS; ++i) {
+		if (frame_words[i] != captured_words[i]) {
+			++cost.direct_words;
+		}
+	}
+	ctx->frame_buffer_captured = false;
+	return true;
+}
+
+/*** Bitmaps ***/
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+	int bytes_per_row;
+	if (format == GBitmapFormat8Bit) {
+		bytes_per_row = size.w;
+	}
+	else if (format == GBitmapFormat1Bit) {
+		/* Rows of 1-bit bitmaps are padded to whole words. */
+		bytes_per_row = (size.w + 31) / 32 * 4;
+	}
+	else {
+		return NULL;
+	}
+
+	if (size.w <= 0 || size.h <= 0) {
+		return NULL;
+	}
+
+	GBitmap *bitmap = calloc(1, sizeof(GBitmap));
+	bitmap->data = calloc(bytes_per_row * size.h, 1);
+	bitmap->bytes_per_row = bytes_per_row;
+	bitmap->format = format;
+	bitmap->bounds = GRect(0, 0, size.w, size.h);
+	return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+	if (bitmap) {
+		free(bitmap->data);
+		free(bitmap);
+	}
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+	return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+	return bitmap->bytes_per_row;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+	return bitmap->format;
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+	return bitmap->bounds;
+}
+
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds) {
+	bitmap->bounds = bounds;
+}
+
+/*** Fonts and resources ***/
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+	return resource_id;
+}
+
+GFont fonts_load_custom_font(ResHandle handle) {
+	int size;
+	switch (handle) {
+		case RESOURCE_ID_FONT_OXYGEN_MONO_27: size = 27; break;
+		case RESOURCE_ID_FONT_OXYGEN_MONO_20: size = 20; break;
+		case RESOURCE_ID_FONT_OXYGEN_MONO_17: size = 17; break;
+		default: return NULL;
+	}
+
+	GFont font = malloc(sizeof(struct GFontStub));
+	font->size = size;
+	return font;
+}
+
+void fonts_unload_custom_font(GFont font) {
+	free(font);
+}
+
+/*** Layers and windows ***/
+
+Layer *layer_create(GRect frame) {
+	Layer *layer = calloc(1, sizeof(Layer));
+	layer->frame = frame;
+	return layer;
+}
+
+void layer_destroy(Layer *layer) {
+	if (!layer) {
+		return;
+	}
+
+	if (layer->parent) {
+		Layer **link = &layer->parent->first_child;
+		while (*link != layer) {
+			link = &(*link)->next_sibling;
+		}
+		*link = layer->next_sibling;
+	}
+	for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+		child->parent = NULL;
+	}
+	free(layer);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+	layer->update_proc = update_proc;
+}
+
+void layer_mark_dirty(Layer *layer) {
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+	return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+GRect layer_get_unobstructed_bounds(const Layer *layer) {
+	return GRect(0, 0, layer->frame.size.w, MIN(layer->frame.size.h, unobstructed_height));
+}
+#endif
+
+void layer_add_child(Layer *parent, Layer *child) {
+	Layer **link = &parent->first_child;
+	while (*link) {
+		link = &(*link)->next_sibling;
+	}
+	*link = child;
+	child->parent = parent;
+	child->next_sibling = NULL;
+}
+
+Window *window_create(void) {
+	Window *window = calloc(1, sizeof(Window));
+	window->root_layer = layer_create(GRect(0, 0, SCREEN_W, SCREEN_H));
+	window->background_color = GColorWhite;
+	return window;
+}
+
+void window_destroy(Window *window) {
+	if (window->handlers.unload) {
+		window->handlers.unload(window);
+	}
+	layer_destroy(window->root_layer);
+	free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+	window->handlers = handlers;
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+	window->background_color = background_color;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+	return window->root_layer;
+}
+
+void window_stack_push(Window *window, bool animated) {
+	if (window->handlers.load) {
+		window->handlers.load(window);
+	}
+}
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context) {
+	unobstructed_handlers = handlers;
+	unobstructed_context = context;
+}
+
+void unobstructed_area_service_unsubscribe(void) {
+	memset(&unobstructed_handlers, 0, sizeof(unobstructed_handlers));
+}
+#endif
+
+/*** Services ***/
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+	battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+	battery_handler = NULL;
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+	return battery;
+}
+
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+	health_handler = handler;
+	health_context = context;
+	return true;
+}
+
+bool health_service_events_unsubscribe(void) {
+	health_handler = NULL;
+	return true;
+}
+
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric,
+																time_t time_start, time_t time_end) {
+	return HealthServiceAccessibilityMaskAvailable;
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+	return metric == HealthMetricStepCount ? steps_today : 0;
+}
+
+/**
+ * Steps recorded in the minute starting at the given time: none at night,
+ * and a fixed pseudo-random number of up to 63 during the day.
+ */
+static uint8_t steps_in_minute(time_t minute_start) {
+	int hour = (minute_start % SECONDS_PER_DAY) / SECONDS_PER_HOUR;
+	if (hour < 7 || hour >= 22) {
+		return 0;
+	}
+	uint32_t hash = (uint32_t) (minute_start / 60) * 2654435761u;
+	return (hash >> 26) & 0x3F;
+}
+
+HealthValue health_service_sum(HealthMetric metric, time_t time_start, time_t time_end) {
+	HealthValue sum = 0;
+	for (time_t t = time_start; t < time_end; t += 60) {
+		sum += steps_in_minute(t);
+	}
+	return metric == HealthMetricStepCount ? sum : 0;
+}
+
+HealthActivityMask health_service_peek_current_activities(void) {
+	return activities;
+}
+
+uint32_t health_service_get_minute_history(HealthMinuteData *minute_data, uint32_t max_records,
+										   time_t *time_start, time_t *time_end) {
+	uint32_t count = 0;
+	for (time_t t = *time_start; t < *time_end && count < max_records; t += 60, ++count) {
+		memset(&minute_data[count], 0, sizeof(HealthMinuteData));
+		minute_data[count].steps = steps_in_minute(t);
+	}
+	*time_end = *time_start + count * 60;
+	return count;
+}
+
+void light_enable_interaction(void) {
+}
+
+/*** Timers ***/
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+	for (int i = 0; i < MAX_TIMERS; ++i) {
+		if (!timers[i].active) {
+			timers[i] = (struct AppTimer) { true, timeout_ms, callback, callback_data };
+			return &timers[i];
+		}
+	}
+
+	fprintf(stderr, "stub: more than %d timers registered\n", MAX_TIMERS);
+	abort();
+}
+
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms) {
+	if (!timer_handle || !timer_handle->active) {
+		return false;
+	}
+	timer_handle->timeout_ms = new_timeout_ms;
+	return true;
+}
+
+void app_timer_cancel(AppTimer *timer_handle) {
+	if (timer_handle) {
+		timer_handle->active = false;
+	}
+}
+
+/*** Persistent storage ***/
+
+static persist_entry_t *find_persist_entry(uint32_t key) {
+	for (int i = 0; i < MAX_PERSIST_KEYS; ++i) {
+		if (persist_entries[i].used && persist_entries[i].key == key) {
+			return &persist_entries[i];
+		}
+	}
+	return NULL;
+}
+
+bool persist_exists(const uint32_t key) {
+	return find_persist_entry(key) != NULL;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+	persist_entry_t *entry = find_persist_entry(key);
+	if (!entry) {
+		return E_DOES_NOT_EXIST;
+	}
+
+	int size = MIN((int) buffer_size, entry->size);
+	memcpy(buffer, entry->data, size);
+	return size;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+	persist_entry_t *entry = find_persist_entry(key);
+	for (int i = 0; !entry && i < MAX_PERSIST_KEYS; ++i) {
+		if (!persist_entries[i].used) {
+			entry = &persist_entries[i];
+			entry->used = true;
+			entry->key = key;
+		}
+	}
+	if (!entry) {
+		fprintf(stderr, "stub: more than %d persistent storage keys\n", MAX_PERSIST_KEYS);
+		abort();
+	}
+
+	/* The watch silently keeps only the first PERSIST_DATA_MAX_LENGTH bytes. */
+	if (size > PERSIST_DATA_MAX_LENGTH) {
+		++persist_truncated_writes;
+	}
+	entry->size = MIN(size, PERSIST_DATA_MAX_LENGTH);
+	memcpy(entry->data, data, entry->size);
+	return entry->size;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+	int32_t value = 0;
+	persist_read_data(key, &value, sizeof(value));
+	return value;
+}
+
+int persist_write_int(const uint32_t key, const int32_t value) {
+	return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_delete(const uint32_t key) {
+	persist_entry_t *entry = find_persist_entry(key);
+	if (!entry) {
+		return E_DOES_NOT_EXIST;
+	}
+	entry->used = false;
+	return 0;
+}
+
+/*** AppMessage ***/
+
+/* Nothing is ever received, and sent messages are only counted. */
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+	return NULL;
+}
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+	return NULL;
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+	return NULL;
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value) {
+	return DICT_OK;
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value) {
+	return DICT_OK;
+}
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+	return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+	*iterator = &outbox_iterator;
+	return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+	++outbox_messages_sent;
+	return APP_MSG_OK;
+}
+
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+}
+
+void app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {
+}
+
+void app_message_register_outbox_sent(AppMessageOutboxSent sent_callback) {
+}
+
+void app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback) {
+}
+
+/* Laid out as the SDK assigns them from package.json, with room for the
+array settings. */
+const uint32_t MESSAGE_KEY_FetchTemperature = 10000;
+const uint32_t MESSAGE_KEY_Temperature = 10001;
+const uint32_t MESSAGE_KEY_SettingsMessage = 10002;
+const uint32_t MESSAGE_KEY_BarCheckboxes = 10003;
+const uint32_t MESSAGE_KEY_BarColors = 10015;
+const uint32_t MESSAGE_KEY_BackgroundColor = 10027;
+const uint32_t MESSAGE_KEY_TextColor = 10028;
+const uint32_t MESSAGE_KEY_TextOutlineColor = 10029;
+const uint32_t MESSAGE_KEY_TemperatureScale = 10030;
+const uint32_t MESSAGE_KEY_TemperatureMinF = 10031;
+const uint32_t MESSAGE_KEY_TemperatureMaxF = 10032;
+const uint32_t MESSAGE_KEY_TemperatureMinC = 10033;
+const uint32_t MESSAGE_KEY_TemperatureMaxC = 10034;
+const uint32_t MESSAGE_KEY_BarStyle = 10035;
+const uint32_t MESSAGE_KEY_RemoteMetrics = 10036;
+const uint32_t MESSAGE_KEY_StepsSparkline = 10037;
+const uint32_t MESSAGE_KEY_QuietModeSleep = 10038;
+const uint32_t MESSAGE_KEY_QuietModeWindow = 10039;
+const uint32_t MESSAGE_KEY_QuietStartHour = 10040;
+const uint32_t MESSAGE_KEY_QuietEndHour = 10041;
+const uint32_t MESSAGE_KEY_Latitude = 10042;
+const uint32_t MESSAGE_KEY_Longitude = 10043;
+const uint32_t MESSAGE_KEY_BackgroundWorker = 10044;
+const uint32_t MESSAGE_KEY_PhoneReady = 10045;
+
+/*** Background worker ***/
+
+AppWorkerResult app_worker_launch(void) {
+	if (worker_running) {
+		return APP_WORKER_RESULT_ALREADY_RUNNING;
+	}
+	worker_running = true;
+	return APP_WORKER_RESULT_SUCCESS;
+}
+
+AppWorkerResult app_worker_kill(void) {
+	if (!worker_running) {
+		return APP_WORKER_RESULT_NOT_RUNNING;
+	}
+	worker_running = false;
+	return APP_WORKER_RESULT_SUCCESS;
+}
+
+bool app_worker_is_running(void) {
+	return worker_running;
+}
+
+/*** Stub controls ***/
+
+void stub_set_time(time_t new_now) {
+	now = new_now;
+}
+
+void stub_set_24h_style(bool is_24h) {
+	is_24h_style = is_24h;
+}
+
+void stub_set_steps(int new_steps_today) {
+	steps_today = new_steps_today;
+}
+
+void stub_set_activities(HealthActivityMask new_activities) {
+	activities = new_activities;
+}
+
+void stub_set_battery(BatteryChargeState state) {
+	battery = state;
+}
+
+void stub_tick(TimeUnits units_changed) {
+	if (tick_handler) {
+		tick_handler(stub_localtime(&now), units_changed);
+	}
+}
+
+void stub_health_event(HealthEventType event) {
+	if (health_handler) {
+		health_handler(event, health_context);
+	}
+}
+
+void stub_battery_event(void) {
+	if (battery_handler) {
+		battery_handler(battery);
+	}
+}
+
+void stub_run_due_timers(void) {
+	bool ran;
+	do {
+		ran = false;
+		for (int i = 0; i < MAX_TIMERS; ++i) {
+			if (timers[i].active && timers[i].timeout_ms == 0) {
+				timers[i].active = false;
+				timers[i].callback(timers[i].data);
+				ran = true;
+			}
+		}
+	} while (ran);
+}
+
+void stub_unobstructed_will_change(int final_height) {
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+	if (unobstructed_handlers.will_change) {
+		unobstructed_handlers.will_change(GRect(0, 0, SCREEN_W, final_height), unobstructed_context);
+	}
+#endif
+}
+
+void stub_unobstructed_change(AnimationProgress progress, int height) {
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+	unobstructed_height = height;
+	if (unobstructed_handlers.change) {
+		unobstructed_handlers.change(progress, unobstructed_context);
+	}
+#endif
+}
+
+void stub_unobstructed_did_change(int final_height) {
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+	unobstructed_height = final_height;
+	if (unobstructed_handlers.did_change) {
+		unobstructed_handlers.did_change(unobstructed_context);
+	}
+#endif
+}
+
+void stub_persist_clear(void) {
+	memset(persist_entries, 0, sizeof(persist_entries));
+}
+
+int stub_persist_truncated_writes(void) {
+	return persist_truncated_writes;
+}
+
+/**
+ * Draws a layer and then its children, in the order they were added.
+ */
+static void render_layer(Layer *layer) {
+	if (layer->update_proc) {
+		layer->update_proc(layer, &context);
+	}
+	for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+		render_layer(child);
+	}
+}
+
+stub_cost_t stub_render(Window *window) {
+	GColor background = window->background_color;
+#if defined(PBL_COLOR)
+	memset(frame_buffer.data, background.argb | 0xC0, sizeof(frame_words));
+#else
+	memset(frame_buffer.data, is_white(background) ? 0xFF : 0x00, sizeof(frame_words));
+#endif
+
+	context = (GContext) {
+		.fill_color = GColorBlack,
+		.stroke_color = GColorBlack,
+		.text_color = GColorBlack,
+		.compositing_mode = GCompOpAssign
+	};
+	memset(&cost, 0, sizeof(cost));
+
+	render_layer(window->root_layer);
+
+	if (context.frame_buffer_captured) {
+		fprintf(stderr, "stub: frame buffer still captured at the end of the frame\n");
+		abort();
+	}
+	return cost;
+}
+
+uint32_t stub_cost_total(stub_cost_t frame_cost) {
+	return frame_cost.calls * STUB_CALL_COST + frame_cost.pixels + frame_cost.direct_words;
+}
+
+uint32_t stub_frame_hash(void) {
+	/* FNV-1a over the visible pixels, skipping the padding at the end of each row. */
+	uint32_t hash = 2166136261u;
+	int visible_bytes = PBL_IF_COLOR_ELSE(SCREEN_W, SCREEN_W / 8);
+	for (int y = 0; y < SCREEN_H; ++y) {
+		const uint8_t *row = frame_buffer.data + y * FRAME_BYTES_PER_ROW;
+		for (int i = 0; i < visible_bytes; ++i) {
+			hash ^= row[i];
+			hash *= 16777619u;
+		}
+	}
+	return hash;
+}
+
+bool stub_write_image(const char *path) {
+	FILE *file = fopen(path, "wb");
+	if (!file) {
+		return false;
+	}
+
+#if defined(PBL_COLOR)
+	fprintf(file, "P6\n%d %d\n255\n", SCREEN_W, SCREEN_H);
+	for (int y = 0; y < SCREEN_H; ++y) {
+		for (int x = 0; x < SCREEN_W; ++x) {
+			GColor pixel = { .argb = frame_buffer.data[y * FRAME_BYTES_PER_ROW + x] };
+			fputc(pixel.r * 85, file);
+			fputc(pixel.g * 85, file);
+			fputc(pixel.b * 85, file);
+		}
+	}
+#else
+	/* PBM rows are most significant bit first, with 1 for black. */
+	const int visible_bytes = SCREEN_W / 8;
+	fprintf(file, "P4\n%d %d\n", SCREEN_W, SCREEN_H);
+	for (int y = 0; y < SCREEN_H; ++y) {
+		const uint8_t *row = frame_buffer.data + y * FRAME_BYTES_PER_ROW;
+		for (int i = 0; i < visible_bytes; ++i) {
+			uint8_t byte = 0;
+			for (int bit = 0; bit < 8; ++bit) {
+				if (!((row[i] >> bit) & 1)) {
+					byte |= 0x80 >> bit;
+				}
+			}
+			fputc(byte, file);
+		}
+	}
+#endif
+
+	return fclose(file) == 0;
+}
+
+bool stub_worker_running(void) {
+	return worker_running;
+}
+
+int stub_outbox_messages_sent(void) {
+	return outbox_messages_sent;
+}
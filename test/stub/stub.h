@@ -0,0 +1,67 @@
+#pragma once
+
+#include <pebble.h>
+
+/*
+ * Controls for the host stand-in of the Pebble SDK, used by the sweep driver
+ * to set up what the watch would report and to draw frames.
+ */
+
+/**
+ * How much drawing a frame took, in units that do not depend on the host: each
+ * graphics call costs STUB_CALL_COST, each pixel the stub writes costs 1, and
+ * each 32-bit word of the frame buffer changed directly by the app costs 1.
+ */
+#define STUB_CALL_COST 64
+
+typedef struct {
+	uint32_t calls;
+	uint32_t pixels;
+	uint32_t direct_words;
+} stub_cost_t;
+
+/*** Clock and sensors ***/
+void stub_set_time(time_t now);
+void stub_set_24h_style(bool is_24h);
+void stub_set_steps(int steps_today);
+void stub_set_activities(HealthActivityMask activities);
+void stub_set_battery(BatteryChargeState state);
+
+/*** Services ***/
+
+/* Each of these calls the app's handler, if it is subscribed. */
+void stub_tick(TimeUnits units_changed);
+void stub_health_event(HealthEventType event);
+void stub_battery_event(void);
+
+/* Calls every timer registered with a delay of 0, including ones registered
+while doing so. Longer timers never fire. */
+void stub_run_due_timers(void);
+
+/* Moves the timeline quick view, calling the app's handlers as the watch would.
+Does nothing on platforms without it. */
+void stub_unobstructed_will_change(int final_height);
+void stub_unobstructed_change(AnimationProgress progress, int height);
+void stub_unobstructed_did_change(int final_height);
+
+/*** Storage ***/
+void stub_persist_clear(void);
+
+/* Number of writes that were cut off at PERSIST_DATA_MAX_LENGTH. */
+int stub_persist_truncated_writes(void);
+
+/*** Drawing ***/
+
+/* Draws the window and its layers into the frame buffer, returning the cost of
+drawing the layers. The window background is not counted. */
+stub_cost_t stub_render(Window *window);
+
+uint32_t stub_cost_total(stub_cost_t cost);
+uint32_t stub_frame_hash(void);
+
+/* Writes the frame buffer as a PPM (color) or PBM (black and white) image. */
+bool stub_write_image(const char *path);
+
+/*** Misc ***/
+bool stub_worker_running(void);
+int stub_outbox_messages_sent(void);
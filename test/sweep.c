@@ -0,0 +1,586 @@
+#include <pebble.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "bars.h"
+#include "stub.h"
+
+/*
+ * Draws the watchface over a sweep of configurations and states, and prints
+ * one line per case with a hash of the pixels and the cost of drawing them
+ * (see stub_cost_t). Given a baseline of earlier results, reports the cases
+ * whose pixels changed or whose cost went up, and fails if there are any.
+ *
+ *   sweep [--compare BASELINE] [--tolerance PERCENT] [--images DIR]
+ *
+ * With --images, the frames of the cases that differ from the baseline are
+ * written to DIR, or every frame if there is no baseline.
+ */
+
+/*** Constants ***/
+
+/* Height left uncovered by the timeline quick view. */
+#define QUICK_VIEW_HEIGHT (PBL_DISPLAY_HEIGHT - 51)
+
+#define MAX_CASES 4096
+#define CASE_NAME_LENGTH 64
+
+#if defined(PBL_PLATFORM_BASALT)
+static const char PLATFORM_NAME[] = "basalt";
+#elif defined(PBL_PLATFORM_DIORITE)
+static const char PLATFORM_NAME[] = "diorite";
+#else
+static const char PLATFORM_NAME[] = "aplite";
+#endif
+
+/*** Types ***/
+
+/**
+ * What the watch reports while a case is drawn.
+ */
+typedef struct {
+	time_t time;
+	bool is_24h;
+	int temperature_f;
+	int steps;
+	BatteryChargeState battery;
+} sweep_state_t;
+
+typedef struct {
+	char name[CASE_NAME_LENGTH];
+	uint32_t hash;
+	uint32_t cost;
+} sweep_result_t;
+
+/*** Internal Global Variables ***/
+static Window *window;
+
+/* The settings the app starts with, before any are received. */
+static app_settings_t default_settings;
+
+static sweep_result_t baseline[MAX_CASES];
+static int baseline_count;
+static bool have_baseline;
+static double tolerance_percent = 5;
+static const char *image_dir;
+
+static int case_count;
+static int changed_count;
+static int regressed_count;
+static int missing_count;
+static uint64_t total_cost;
+static uint64_t total_baseline_cost;
+static double total_render_us;
+
+/*** Setup ***/
+
+/**
+ * Returns a UTC time. The watch's local time is UTC in the stub.
+ */
+static time_t make_time(int year, int month, int day, int hour, int minute, int second) {
+	struct tm tm = {
+		.tm_year = year - 1900, .tm_mon = month - 1, .tm_mday = day,
+		.tm_hour = hour, .tm_min = minute, .tm_sec = second
+	};
+	return timegm(&tm);
+}
+
+static sweep_state_t base_state() {
+	return (sweep_state_t) {
+		.time = make_time(2023, 6, 15, 13, 7, 42),
+		.is_24h = true,
+		.temperature_f = 66,
+		.steps = 4321,
+		.battery = { .charge_percent = 70 }
+	};
+}
+
+/**
+ * Returns the default settings with only the given bars shown.
+ *
+ * @param uint32_t bars: Bit i set shows the bar with index i.
+ */
+static app_settings_t settings_with_bars(uint32_t bars, bar_style_e style) {
+	app_settings_t settings = default_settings;
+	for (int i = 0; i < TOTAL_BARS; ++i) {
+		settings.show_bar[i] = (bars >> i) & 1;
+	}
+	settings.bar_style = style;
+	return settings;
+}
+
+static void main_window_load(Window *a_window) {
+	layer_add_child(window_get_root_layer(a_window), bars_create_layer());
+}
+
+/*** Cases ***/
+
+static const sweep_result_t* find_baseline(const char *name, int hint) {
+	if (hint < baseline_count && strcmp(baseline[hint].name, name) == 0) {
+		return &baseline[hint];
+	}
+	for (int i = 0; i < baseline_count; ++i) {
+		if (strcmp(baseline[i].name, name) == 0) {
+			return &baseline[i];
+		}
+	}
+	return NULL;
+}
+
+static void write_image(const char *name) {
+	char path[256];
+	char file_name[CASE_NAME_LENGTH];
+	snprintf(file_name, sizeof(file_name), "%s", name);
+	for (char *c = file_name; *c; ++c) {
+		if (*c == '/') {
+			*c = '_';
+		}
+	}
+
+	snprintf(path, sizeof(path), "%s/%s.%s", image_dir, file_name, PBL_IF_COLOR_ELSE("ppm", "pbm"));
+	if (!stub_write_image(path)) {
+		fprintf(stderr, "Could not write %s: %s\n", path, strerror(errno));
+	}
+}
+
+/**
+ * Draws the current frame as a case, prints its result and checks it against
+ * the baseline.
+ */
+static void record(const char *name) {
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	stub_cost_t cost = stub_render(window);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	total_render_us += (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3;
+
+	uint32_t hash = stub_frame_hash();
+	uint32_t total = stub_cost_total(cost);
+	printf("%s %08x %u\n", name, hash, total);
+
+	total_cost += total;
+	bool write = image_dir && !have_baseline;
+
+	if (have_baseline) {
+		const sweep_result_t *expected = find_baseline(name, case_count);
+		if (!expected) {
+			fprintf(stderr, "NEW      %s\n", name);
+			++missing_count;
+		}
+		else {
+			total_baseline_cost += expected->cost;
+			if (expected->hash != hash) {
+				fprintf(stderr, "PIXELS   %s: %08x, was %08x\n", name, hash, expected->hash);
+				++changed_count;
+				write = image_dir != NULL;
+			}
+			if (total > expected->cost * (1 + tolerance_percent / 100)) {
+				fprintf(stderr, "COST     %s: %u, was %u (+%.1f%%)\n", name, total, expected->cost,
+						100.0 * total / expected->cost - 100);
+				++regressed_count;
+			}
+		}
+	}
+
+	if (write) {
+		write_image(name);
+	}
+	++case_count;
+}
+
+/**
+ * Puts the watch in the given state and brings every bar up to date, as the
+ * services would after the settings were received.
+ */
+static void apply(const app_settings_t *settings, const sweep_state_t *state) {
+	stub_set_time(state->time);
+	stub_set_24h_style(state->is_24h);
+	stub_set_steps(state->steps);
+	stub_set_battery(state->battery);
+
+	bars_handle_settings_received(settings, window);
+	bars_handle_temperature_received(state->temperature_f);
+
+	stub_tick(SECOND_UNIT|MINUTE_UNIT|HOUR_UNIT|DAY_UNIT|MONTH_UNIT|YEAR_UNIT);
+	stub_health_event(HealthEventSignificantUpdate);
+	stub_battery_event();
+	stub_run_due_timers();
+}
+
+static void run_case(const char *name, const app_settings_t *settings, const sweep_state_t *state) {
+	apply(settings, state);
+	record(name);
+}
+
+/**
+ * Sets the metrics pushed by the phone to the first count of three.
+ */
+static void set_remote_metrics(int count) {
+	static const struct {
+		uint8_t color;
+		uint16_t progress_permille;
+		const char *label;
+	} METRICS[] = {
+		{ 0xF4, 420, "42%" },
+		{ 0xCF, 0, "0" },
+		{ 0xFE, 1500, "1234567" }
+	};
+
+	uint8_t frame[64];
+	int length = 1;
+	frame[0] = ARRAY_LENGTH(METRICS);
+
+	for (unsigned int i = 0; i < ARRAY_LENGTH(METRICS); ++i) {
+		int label_length = strlen(METRICS[i].label);
+		uint16_t progress = (int) i < count ? METRICS[i].progress_permille : REMOTE_METRIC_REMOVE;
+		frame[length++] = i + 1;
+		frame[length++] = PBL_IF_COLOR_ELSE(METRICS[i].color, i % 2 ? 0xEA : 0xFF);
+		frame[length++] = progress & 0xFF;
+		frame[length++] = progress >> 8;
+		frame[length++] = label_length;
+		memcpy(&frame[length], METRICS[i].label, label_length);
+		length += label_length;
+	}
+
+	bars_handle_remote_metrics_received(frame, length);
+}
+
+/**
+ * Every combination of bars the config page allows, in both bar styles. A
+ * combined bar is never shown along with its separate bars.
+ */
+static void sweep_layouts() {
+	static const uint32_t TIME_BARS[] = {
+		0, 1 << HOURS_BAR_IDX, 1 << MINUTES_BAR_IDX, (1 << HOURS_BAR_IDX) | (1 << MINUTES_BAR_IDX),
+		1 << COMBINED_HOURS_MINUTES_BAR_IDX
+	};
+	static const uint32_t DATE_BARS[] = {
+		0, 1 << MONTH_BAR_IDX, 1 << DAY_BAR_IDX, (1 << MONTH_BAR_IDX) | (1 << DAY_BAR_IDX),
+		1 << COMBINED_MONTH_DAY_BAR_IDX
+	};
+	static const int OTHER_BARS[] = {
+		SECONDS_BAR_IDX, WEEKDAY_BAR_IDX, TEMPERATURE_BAR_IDX, STEPS_BAR_IDX, BATTERY_BAR_IDX, DAYLIGHT_BAR_IDX
+	};
+
+	sweep_state_t state = base_state();
+
+	for (int style = SOLID; style <= OUTLINE; ++style) {
+		for (unsigned int t = 0; t < ARRAY_LENGTH(TIME_BARS); ++t) {
+			for (unsigned int d = 0; d < ARRAY_LENGTH(DATE_BARS); ++d) {
+				for (uint32_t o = 0; o < 1u << ARRAY_LENGTH(OTHER_BARS); ++o) {
+					uint32_t bars = TIME_BARS[t] | DATE_BARS[d];
+					for (unsigned int i = 0; i < ARRAY_LENGTH(OTHER_BARS); ++i) {
+						if ((o >> i) & 1) {
+							bars |= 1 << OTHER_BARS[i];
+						}
+					}
+
+					char name[CASE_NAME_LENGTH];
+					snprintf(name, sizeof(name), "layout/%s/%03x", style == SOLID ? "solid" : "outline", bars);
+					app_settings_t settings = settings_with_bars(bars, style);
+					run_case(name, &settings, &state);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * One factor at a time away from a base state, for a configuration in each of
+ * the three font sizes.
+ */
+static void sweep_states(const char *tier, uint32_t bars, bar_style_e style) {
+	char prefix[CASE_NAME_LENGTH / 2];
+	char name[CASE_NAME_LENGTH];
+	snprintf(prefix, sizeof(prefix), "%s/%s", tier, style == SOLID ? "solid" : "outline");
+
+	const app_settings_t base_settings = settings_with_bars(bars, style);
+	const sweep_state_t base = base_state();
+	app_settings_t settings;
+	sweep_state_t state;
+
+	snprintf(name, sizeof(name), "%s/base", prefix);
+	run_case(name, &base_settings, &base);
+
+	/* Edge times, in 24h and 12h style. */
+	static const struct {
+		const char *label;
+		int fields[6];
+	} TIMES[] = {
+		{ "midnight", { 2024, 1, 1, 0, 0, 0 } },
+		{ "leapday", { 2024, 2, 29, 12, 0, 0 } },
+		{ "yearend", { 2024, 12, 31, 23, 59, 59 } },
+		{ "morning", { 2023, 3, 5, 9, 5, 5 } },
+		{ "noon", { 2023, 7, 4, 12, 30, 30 } }
+	};
+	for (int is_24h = 1; is_24h >= 0; --is_24h) {
+		for (unsigned int i = 0; i < ARRAY_LENGTH(TIMES); ++i) {
+			const int *f = TIMES[i].fields;
+			state = base;
+			state.time = make_time(f[0], f[1], f[2], f[3], f[4], f[5]);
+			state.is_24h = is_24h;
+			snprintf(name, sizeof(name), "%s/time/%s-%s", prefix, TIMES[i].label, is_24h ? "24h" : "12h");
+			run_case(name, &base_settings, &state);
+		}
+	}
+
+	/* Temperatures below, at and above each end of the range, in both scales. */
+	static const int TEMPERATURES_F[] = { -40, 32, 66, 100, 140 };
+	for (unsigned int i = 0; i < ARRAY_LENGTH(TEMPERATURES_F); ++i) {
+		state = base;
+		state.temperature_f = TEMPERATURES_F[i];
+		snprintf(name, sizeof(name), "%s/temperature/%dF", prefix, TEMPERATURES_F[i]);
+		run_case(name, &base_settings, &state);
+	}
+
+	static const int TEMPERATURES_C_AS_F[] = { -40, 14, 50, 104, 122 };
+	settings = base_settings;
+	settings.temperature_scale = CELSIUS;
+	settings.temperature_min = -10;
+	settings.temperature_max = 40;
+	for (unsigned int i = 0; i < ARRAY_LENGTH(TEMPERATURES_C_AS_F); ++i) {
+		state = base;
+		state.temperature_f = TEMPERATURES_C_AS_F[i];
+		snprintf(name, sizeof(name), "%s/temperature/%dF-as-C", prefix, TEMPERATURES_C_AS_F[i]);
+		run_case(name, &settings, &state);
+	}
+
+	/* Step counts, as a bar and as a sparkline. */
+	static const int STEPS[] = { 0, 1, 9999, 10000, 99999 };
+	for (int sparkline = 0; sparkline <= 1; ++sparkline) {
+		if (!((bars >> STEPS_BAR_IDX) & 1)) {
+			break;
+		}
+		settings = base_settings;
+		settings.steps_sparkline = sparkline;
+		for (unsigned int i = 0; i < ARRAY_LENGTH(STEPS); ++i) {
+			state = base;
+			state.steps = STEPS[i];
+			snprintf(name, sizeof(name), "%s/%s/%d", prefix, sparkline ? "sparkline" : "steps", STEPS[i]);
+			run_case(name, &settings, &state);
+		}
+	}
+
+	/* The sparkline in each shade, which black and white platforms dither. */
+	static const uint8_t SPARKLINE_COLORS[] = { 0xC0, 0xD5, 0xEA, 0xFF };
+	for (unsigned int i = 0; (bars >> STEPS_BAR_IDX) & 1 && i < ARRAY_LENGTH(SPARKLINE_COLORS); ++i) {
+		settings = base_settings;
+		settings.steps_sparkline = true;
+		settings.bar_colors[STEPS_BAR_IDX] = GColorARGB8(SPARKLINE_COLORS[i]);
+		snprintf(name, sizeof(name), "%s/sparkline-color/%02x", prefix, SPARKLINE_COLORS[i]);
+		run_case(name, &settings, &base);
+	}
+
+	/* Battery. */
+	static const BatteryChargeState BATTERY[] = {
+		{ .charge_percent = 0 }, { .charge_percent = 10 }, { .charge_percent = 100, .is_charging = true }
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(BATTERY); ++i) {
+		state = base;
+		state.battery = BATTERY[i];
+		snprintf(name, sizeof(name), "%s/battery/%d", prefix, BATTERY[i].charge_percent);
+		run_case(name, &base_settings, &state);
+	}
+
+	/* Text and background colors, including labels with no visible outline. */
+	static const struct {
+		const char *label;
+		uint8_t background, text, outline;
+	} TEXT_COLORS[] = {
+		{ "white-on-white", 0xFF, 0xFF, 0xFF },
+		{ "black-outline-white", 0xFF, 0xC0, 0xFF },
+		{ "black-on-black", 0xC0, 0xC0, 0xC0 },
+		{ "clear-outline", 0xC0, 0xFF, 0x00 }
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(TEXT_COLORS); ++i) {
+		settings = base_settings;
+		settings.background_color = GColorARGB8(TEXT_COLORS[i].background);
+		settings.text_color = GColorARGB8(TEXT_COLORS[i].text);
+		settings.text_outline_color = GColorARGB8(TEXT_COLORS[i].outline);
+		snprintf(name, sizeof(name), "%s/text/%s", prefix, TEXT_COLORS[i].label);
+		run_case(name, &settings, &base);
+	}
+
+	/* Bar colors covering every dither level on black and white. */
+	static const uint8_t BAR_COLORS[] = { 0xC0, 0xD5, 0xEA, 0xFF, 0xF0, 0xC3 };
+	settings = base_settings;
+	for (int i = 0; i < TOTAL_BARS; ++i) {
+		settings.bar_colors[i] = GColorARGB8(BAR_COLORS[i % ARRAY_LENGTH(BAR_COLORS)]);
+	}
+	snprintf(name, sizeof(name), "%s/bar-colors", prefix);
+	run_case(name, &settings, &base);
+
+	/* Metrics pushed by the phone. */
+	for (int count = 1; count <= MAX_REMOTE_METRICS; ++count) {
+		set_remote_metrics(count);
+		snprintf(name, sizeof(name), "%s/remote/%d", prefix, count);
+		run_case(name, &base_settings, &base);
+	}
+	set_remote_metrics(0);
+
+	/* Daylight before sunrise, during the day, after sunset and where the sun does not rise or set. */
+	if ((bars >> DAYLIGHT_BAR_IDX) & 1) {
+		static const int HOURS[] = { 3, 12, 22 };
+		for (unsigned int i = 0; i < ARRAY_LENGTH(HOURS); ++i) {
+			state = base;
+			state.time = make_time(2023, 6, 15, HOURS[i], 0, 0);
+			snprintf(name, sizeof(name), "%s/daylight/%02d", prefix, HOURS[i]);
+			run_case(name, &base_settings, &state);
+		}
+
+		bars_handle_location_received(8000, 0);
+		state = base;
+		state.time = make_time(2023, 12, 21, 12, 0, 0);
+		snprintf(name, sizeof(name), "%s/daylight/polar-night", prefix);
+		run_case(name, &base_settings, &state);
+
+		state.time = make_time(2023, 6, 21, 12, 0, 0);
+		snprintf(name, sizeof(name), "%s/daylight/polar-day", prefix);
+		run_case(name, &base_settings, &state);
+		bars_handle_location_received(4071, -7401);
+	}
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+	/* The timeline quick view sliding in and out, with the steps as a sparkline if shown. */
+	settings = base_settings;
+	settings.steps_sparkline = (bars >> STEPS_BAR_IDX) & 1;
+	apply(&settings, &base);
+
+	static const AnimationProgress PROGRESS[] = {
+		0, ANIMATION_NORMALIZED_MAX / 4, ANIMATION_NORMALIZED_MAX / 2,
+		ANIMATION_NORMALIZED_MAX * 3 / 4, ANIMATION_NORMALIZED_MAX
+	};
+	for (int direction = 0; direction <= 1; ++direction) {
+		int from = direction == 0 ? PBL_DISPLAY_HEIGHT : QUICK_VIEW_HEIGHT;
+		int to = direction == 0 ? QUICK_VIEW_HEIGHT : PBL_DISPLAY_HEIGHT;
+		const char *label = direction == 0 ? "in" : "out";
+
+		stub_unobstructed_will_change(to);
+		for (unsigned int i = 0; i < ARRAY_LENGTH(PROGRESS); ++i) {
+			stub_unobstructed_change(PROGRESS[i], from + (to - from) * PROGRESS[i] / ANIMATION_NORMALIZED_MAX);
+			snprintf(name, sizeof(name), "%s/quickview/%s-%d", prefix, label,
+					 PROGRESS[i] * 100 / ANIMATION_NORMALIZED_MAX);
+			record(name);
+		}
+		stub_unobstructed_did_change(to);
+		snprintf(name, sizeof(name), "%s/quickview/%s-done", prefix, label);
+		record(name);
+	}
+#endif
+}
+
+/*** Baseline ***/
+
+static bool load_baseline(const char *path) {
+	FILE *file = fopen(path, "r");
+	if (!file) {
+		fprintf(stderr, "Could not open %s: %s\n", path, strerror(errno));
+		return false;
+	}
+
+	char line[256];
+	while (fgets(line, sizeof(line), file) && baseline_count < MAX_CASES) {
+		if (line[0] == '#' || line[0] == '\n') {
+			continue;
+		}
+		sweep_result_t *result = &baseline[baseline_count];
+		if (sscanf(line, "%63s %x %u", result->name, &result->hash, &result->cost) == 3) {
+			++baseline_count;
+		}
+	}
+
+	fclose(file);
+	have_baseline = true;
+	return true;
+}
+
+/*** Main ***/
+
+int main(int argc, char **argv) {
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+			if (!load_baseline(argv[++i])) {
+				return 2;
+			}
+		}
+		else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+			tolerance_percent = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--images") == 0 && i + 1 < argc) {
+			image_dir = argv[++i];
+			mkdir(image_dir, 0755);
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--compare BASELINE] [--tolerance PERCENT] [--images DIR]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	printf("# %s: case, pixel hash, cost\n", PLATFORM_NAME);
+
+	/* Start up as the app does, before the phone has sent anything. */
+	sweep_state_t state = base_state();
+	stub_set_time(state.time);
+	stub_set_steps(state.steps);
+	stub_set_battery(state.battery);
+
+	window = window_create();
+	window_set_window_handlers(window, (WindowHandlers) { .load = main_window_load });
+	window_stack_push(window, true);
+	bars_init(window);
+	stub_run_due_timers();
+	default_settings = *bars_get_settings();
+	record("startup/defaults");
+
+	/* The daylight bar before the location is known. */
+	app_settings_t settings = settings_with_bars((1 << COMBINED_HOURS_MINUTES_BAR_IDX) | (1 << DAYLIGHT_BAR_IDX), SOLID);
+	run_case("startup/daylight-no-location", &settings, &state);
+	bars_handle_location_received(4071, -7401);
+
+	sweep_layouts();
+
+	/* One configuration for each font size: 4, 7 and 10 bars. */
+	static const struct {
+		const char *tier;
+		uint32_t bars;
+	} TIERS[] = {
+		{ "font27", (1 << COMBINED_HOURS_MINUTES_BAR_IDX) | (1 << SECONDS_BAR_IDX) |
+			(1 << WEEKDAY_BAR_IDX) | (1 << COMBINED_MONTH_DAY_BAR_IDX) },
+		{ "font20", (1 << COMBINED_HOURS_MINUTES_BAR_IDX) | (1 << SECONDS_BAR_IDX) |
+			(1 << WEEKDAY_BAR_IDX) | (1 << COMBINED_MONTH_DAY_BAR_IDX) | (1 << TEMPERATURE_BAR_IDX) |
+			(1 << STEPS_BAR_IDX) | (1 << BATTERY_BAR_IDX) },
+		{ "font17", (1 << HOURS_BAR_IDX) | (1 << MINUTES_BAR_IDX) | (1 << SECONDS_BAR_IDX) |
+			(1 << WEEKDAY_BAR_IDX) | (1 << MONTH_BAR_IDX) | (1 << DAY_BAR_IDX) |
+			(1 << TEMPERATURE_BAR_IDX) | (1 << STEPS_BAR_IDX) | (1 << BATTERY_BAR_IDX) |
+			(1 << DAYLIGHT_BAR_IDX) }
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(TIERS); ++i) {
+		sweep_states(TIERS[i].tier, TIERS[i].bars, SOLID);
+		sweep_states(TIERS[i].tier, TIERS[i].bars, OUTLINE);
+	}
+
+	bars_deinit();
+	window_destroy(window);
+
+	fprintf(stderr, "%s: %d cases, cost %llu, %.1f us per frame on this host\n", PLATFORM_NAME, case_count,
+			(unsigned long long) total_cost, total_render_us / case_count);
+
+	int failures = 0;
+	if (stub_persist_truncated_writes() > 0) {
+		fprintf(stderr, "%s: %d persistent storage writes were over %d bytes\n", PLATFORM_NAME,
+				stub_persist_truncated_writes(), PERSIST_DATA_MAX_LENGTH);
+		++failures;
+	}
+
+	if (have_baseline) {
+		if (case_count != baseline_count) {
+			fprintf(stderr, "%s: %d cases, baseline has %d\n", PLATFORM_NAME, case_count, baseline_count);
+		}
+		fprintf(stderr, "%s: cost %+.2f%% against the baseline; %d cases with changed pixels, "
+				"%d more than %.0f%% costlier, %d not in the baseline\n", PLATFORM_NAME,
+				100.0 * total_cost / total_baseline_cost - 100, changed_count, regressed_count,
+				tolerance_percent, missing_count);
+		failures += changed_count + regressed_count + missing_count + (case_count != baseline_count);
+	}
+
+	return failures > 0;
+}
@@ -0,0 +1,147 @@
+#include <pebble_worker.h>
+#include <string.h>
+#include "../../src/c/worker_state.h"
+
+/*** Internal Global Variables ***/
+
+/* The record shared with the watchface, and the day's step total when it
+was last updated. */
+static worker_state_t state;
+static int last_steps_today;
+
+/*** Internal Functions ***/
+
+/**
+ * Returns the day's step total, or 0 if the health data is not available.
+ *
+ * @return int: The step count for today.
+ */
+static int get_steps_today() {
+	HealthServiceAccessibilityMask mask = health_service_metric_accessible(HealthMetricStepCount,
+		time_start_of_today(), time(NULL));
+
+	if (mask & HealthServiceAccessibilityMaskAvailable) {
+		return health_service_sum_today(HealthMetricStepCount);
+	}
+	return 0;
+}
+
+/**
+ * Saves the record for the watchface to pick up.
+ */
+static void save_state() {
+	persist_write_data(WORKER_STATE_STORAGE_KEY, &state, sizeof(worker_state_t));
+}
+
+/**
+ * Brings the record up to the current hour. Hours that passed while the worker
+ * was not running are read back from the health service; the rest of today's
+ * steps belong to the current hour.
+ *
+ * @param time_t now: The current time.
+ */
+static void catch_up(time_t now) {
+	time_t start_of_today = time_start_of_today();
+	int hour = localtime(&now)->tm_hour;
+	int first_missing_hour = state.hour;
+
+	if (state.version != WORKER_STATE_VERSION || state.start_of_day != start_of_today) {
+		memset(&state, 0, sizeof(worker_state_t));
+		state.version = WORKER_STATE_VERSION;
+		state.start_of_day = start_of_today;
+		first_missing_hour = 0;
+	}
+
+	for (int h = first_missing_hour; h < hour; ++h) {
+		time_t start = start_of_today + h * SECONDS_PER_HOUR;
+		state.steps_per_hour[h] = health_service_sum(HealthMetricStepCount, start, start + SECONDS_PER_HOUR);
+	}
+
+	int steps_today = get_steps_today();
+	int earlier_hours_total = 0;
+	for (int h = 0; h < hour; ++h) {
+		earlier_hours_total += state.steps_per_hour[h];
+	}
+
+	state.hour = hour;
+	state.steps_per_hour[hour] = MAX(steps_today - earlier_hours_total, 0);
+	last_steps_today = steps_today;
+
+	save_state();
+}
+
+/**
+ * Adds the steps since the last update to the current hour.
+ *
+ * @param int steps_today: The day's step total.
+ */
+static void add_steps(int steps_today) {
+	if (steps_today > last_steps_today) {
+		state.steps_per_hour[state.hour] += steps_today - last_steps_today;
+	}
+	last_steps_today = steps_today;
+}
+
+/**
+ * HealthEventHandler called when the health data changes.
+ *
+ * @param HealthEventType event: The type of health event that occurred.
+ * @param void *context: Pointer to application data.
+ */
+static void health_event_callback(HealthEventType event, void *context) {
+	if (event == HealthEventSignificantUpdate || event == HealthEventMovementUpdate) {
+		add_steps(get_steps_today());
+	}
+}
+
+/**
+ * TickHandler called at the start of every hour. Closes the hour that just
+ * ended and saves the record, which is the only time the worker writes it.
+ *
+ * @param struct tm *tick_time: The time at which the tick event was triggered.
+ * @param TimeUnits units_changed: Which unit(s) changed.
+ */
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+	if (units_changed & DAY_UNIT) {
+		catch_up(time(NULL));
+		return;
+	}
+
+	/* The steps since the last update mostly belong to the hour that just ended. */
+	add_steps(get_steps_today());
+
+	state.hour = tick_time->tm_hour;
+	state.steps_per_hour[state.hour] = 0;
+
+	save_state();
+}
+
+/**
+ * Loads the last record and starts collecting.
+ */
+static void init() {
+	if (persist_exists(WORKER_STATE_STORAGE_KEY)) {
+		persist_read_data(WORKER_STATE_STORAGE_KEY, &state, sizeof(worker_state_t));
+	}
+	catch_up(time(NULL));
+
+	health_service_events_subscribe(health_event_callback, NULL);
+	tick_timer_service_subscribe(HOUR_UNIT, tick_handler);
+}
+
+/**
+ * Saves the steps counted so far in the current hour.
+ */
+static void deinit() {
+	add_steps(get_steps_today());
+	save_state();
+}
+
+/**
+ * Initializes and deinitializes the worker and enters the worker event loop.
+ */
+int main(void) {
+	init();
+	worker_event_loop();
+	deinit();
+}